@@ -146,6 +146,8 @@ function(build_pelec_exe pelec_exe_name)
        ${SRC_DIR}/IndexDefines.cpp
        ${SRC_DIR}/IO.H
        ${SRC_DIR}/IO.cpp
+       ${SRC_DIR}/ISAT.H
+       ${SRC_DIR}/ISAT.cpp
        ${SRC_DIR}/LES.H
        ${SRC_DIR}/LES.cpp
        ${SRC_DIR}/MOL.H
@@ -153,13 +155,24 @@ function(build_pelec_exe pelec_exe_name)
        ${SRC_DIR}/Particle.cpp
        ${SRC_DIR}/PeleC.H
        ${SRC_DIR}/PeleC.cpp
+       ${SRC_DIR}/PerfLog.H
+       ${SRC_DIR}/PerfLog.cpp
+       ${SRC_DIR}/PlotCompress.H
+       ${SRC_DIR}/PlotCompress.cpp
        ${SRC_DIR}/Problem.H
        ${SRC_DIR}/ProblemDerive.H
        ${SRC_DIR}/Riemann.H
+       ${SRC_DIR}/Sampling.H
+       ${SRC_DIR}/Sampling.cpp
+       ${SRC_DIR}/ScratchPool.H
+       ${SRC_DIR}/ScratchPool.cpp
        ${SRC_DIR}/Setup.cpp
        ${SRC_DIR}/Sources.cpp
+       ${SRC_DIR}/SumIQ.H
        ${SRC_DIR}/SumIQ.cpp
        ${SRC_DIR}/SumUtils.cpp
+       ${SRC_DIR}/TabulatedProfile.H
+       ${SRC_DIR}/TabulatedProfile.cpp
        ${SRC_DIR}/Tagging.H
        ${SRC_DIR}/Tagging.cpp
        ${SRC_DIR}/Timestep.H
@@ -71,6 +71,11 @@ amrex_probinit(
 }
 }
 
+void
+PeleC::problem_pre_init_data()
+{
+}
+
 void
 PeleC::problem_post_timestep()
 {
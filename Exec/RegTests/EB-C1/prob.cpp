@@ -144,6 +144,11 @@ amrex_probinit(
 }
 }
 
+void
+PeleC::problem_pre_init_data()
+{
+}
+
 void
 PeleC::problem_post_timestep()
 {
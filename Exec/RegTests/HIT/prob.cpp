@@ -114,13 +114,13 @@ amrex_probinit(
     << PeleC::h_prob_parm_device->forcing_force << std::endl;
   ofs.close();
 
-  // Load velocity fields from file. Assume data set ordered in Fortran
-  // format and reshape the data accordingly. One thing to keep in mind
-  // is that this contains the entire input data. We will interpolate
-  // this data later to just match our box. Another assumption is that
-  // the input data is a periodic cube. If the input cube is smaller
-  // than our domain size, the cube will be repeated throughout the
-  // domain (hence the mod operations in the interpolation).
+  // Load the input coordinates. Assume data set ordered in Fortran
+  // format. The velocities are only read later, in
+  // problem_pre_init_data, for the z-planes the boxes of each rank
+  // need. Another assumption is that the input data is a periodic
+  // cube. If the input cube is smaller than our domain size, the cube
+  // will be repeated throughout the domain (hence the mod operations
+  // in the interpolation).
   if (PeleC::h_prob_parm_device->restart) {
     amrex::Print() << "Skipping input file reading and assuming restart."
                    << std::endl;
@@ -131,36 +131,30 @@ amrex_probinit(
     const size_t nx = PeleC::h_prob_parm_device->inres;
     const size_t ny = PeleC::h_prob_parm_device->inres;
     const size_t nz = PeleC::h_prob_parm_device->inres;
-    amrex::Vector<amrex::Real> data(
-      nx * ny * nz * 6); /* this needs to be double */
+    amrex::Vector<amrex::Real> data; /* this needs to be double */
     if (PeleC::h_prob_parm_device->binfmt) {
-      read_binary(PeleC::prob_parm_host->iname, nx, ny, nz, 6, data);
+      read_binary_planes(
+        PeleC::prob_parm_host->iname, nx, ny, nz, 6, {0}, {0}, data);
     } else {
+      // The csv file is read whole, so keep all of its velocities
       read_csv(PeleC::prob_parm_host->iname, nx, ny, nz, data);
-    }
-
-    // Extract position and velocities
-    PeleC::prob_parm_host->h_xinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_uinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_vinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_winput.resize(nx * ny * nz);
-    for (long i = 0; i < PeleC::prob_parm_host->h_xinput.size(); i++) {
-      PeleC::prob_parm_host->h_xinput[i] = data[0 + i * 6];
-      PeleC::prob_parm_host->h_uinput[i] = data[3 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
-      PeleC::prob_parm_host->h_vinput[i] = data[4 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
-      PeleC::prob_parm_host->h_winput[i] = data[5 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
+      PeleC::prob_parm_host->h_uinput.resize(nx * ny * nz);
+      PeleC::prob_parm_host->h_vinput.resize(nx * ny * nz);
+      PeleC::prob_parm_host->h_winput.resize(nx * ny * nz);
+      for (long i = 0; i < PeleC::prob_parm_host->h_uinput.size(); i++) {
+        PeleC::prob_parm_host->h_uinput[i] = data[3 + i * 6];
+        PeleC::prob_parm_host->h_vinput[i] = data[4 + i * 6];
+        PeleC::prob_parm_host->h_winput[i] = data[5 + i * 6];
+      }
+      for (long i = 0; i < nx; i++) {
+        data[i] = data[i * 6];
+      }
     }
 
     // Get the xarray table and the differences.
     PeleC::prob_parm_host->h_xarray.resize(nx);
     for (long i = 0; i < PeleC::prob_parm_host->h_xarray.size(); i++) {
-      PeleC::prob_parm_host->h_xarray[i] = PeleC::prob_parm_host->h_xinput[i];
+      PeleC::prob_parm_host->h_xarray[i] = data[i];
     }
     PeleC::prob_parm_host->h_xdiff.resize(nx);
     std::adjacent_difference(
@@ -177,33 +171,9 @@ amrex_probinit(
     }
 
     // Get pointer to the data
-    PeleC::prob_parm_host->xinput.resize(
-      PeleC::prob_parm_host->h_xinput.size());
-    PeleC::prob_parm_host->uinput.resize(
-      PeleC::prob_parm_host->h_uinput.size());
-    PeleC::prob_parm_host->vinput.resize(
-      PeleC::prob_parm_host->h_vinput.size());
-    PeleC::prob_parm_host->winput.resize(
-      PeleC::prob_parm_host->h_winput.size());
     PeleC::prob_parm_host->xarray.resize(
       PeleC::prob_parm_host->h_xarray.size());
     PeleC::prob_parm_host->xdiff.resize(PeleC::prob_parm_host->h_xdiff.size());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_xinput.begin(),
-      PeleC::prob_parm_host->h_xinput.end(),
-      PeleC::prob_parm_host->xinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_uinput.begin(),
-      PeleC::prob_parm_host->h_uinput.end(),
-      PeleC::prob_parm_host->uinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_vinput.begin(),
-      PeleC::prob_parm_host->h_vinput.end(),
-      PeleC::prob_parm_host->vinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_winput.begin(),
-      PeleC::prob_parm_host->h_winput.end(),
-      PeleC::prob_parm_host->winput.begin());
     amrex::Gpu::copy(
       amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_xarray.begin(),
       PeleC::prob_parm_host->h_xarray.end(),
@@ -213,10 +183,6 @@ amrex_probinit(
       PeleC::prob_parm_host->h_xdiff.end(),
       PeleC::prob_parm_host->xdiff.begin());
 
-    PeleC::h_prob_parm_device->d_xinput = PeleC::prob_parm_host->xinput.data();
-    PeleC::h_prob_parm_device->d_uinput = PeleC::prob_parm_host->uinput.data();
-    PeleC::h_prob_parm_device->d_vinput = PeleC::prob_parm_host->vinput.data();
-    PeleC::h_prob_parm_device->d_winput = PeleC::prob_parm_host->winput.data();
     PeleC::h_prob_parm_device->d_xarray = PeleC::prob_parm_host->xarray.data();
     PeleC::h_prob_parm_device->d_xdiff = PeleC::prob_parm_host->xdiff.data();
 
@@ -229,6 +195,93 @@ amrex_probinit(
 }
 }
 
+void
+PeleC::problem_pre_init_data()
+{
+  if (PeleC::h_prob_parm_device->restart) {
+    return;
+  }
+
+  // Find the input z-planes the boxes of this rank interpolate from
+  const int inres = PeleC::h_prob_parm_device->inres;
+  const amrex::Real Linput = PeleC::h_prob_parm_device->Linput;
+  const amrex::Real* xarray = PeleC::prob_parm_host->h_xarray.data();
+  const amrex::Real zlo = geom.ProbLo(2);
+  const amrex::Real dz = geom.CellSize(2);
+  amrex::Vector<int> kmap(inres, -1);
+  for (amrex::MFIter mfi(get_new_data(State_Type), false); mfi.isValid();
+       ++mfi) {
+    const amrex::Box& bx = mfi.validbox();
+    for (int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++) {
+      const amrex::Real z = zlo + (k + 0.5) * dz;
+      int idx = 0;
+      locate(xarray, inres, std::fmod(z, Linput), idx);
+      kmap[idx] = 1;
+      kmap[(idx + 1) % inres] = 1;
+    }
+  }
+
+  const bool binfmt = PeleC::h_prob_parm_device->binfmt;
+  const amrex::Real scale =
+    PeleC::h_prob_parm_device->urms0 / PeleC::h_prob_parm_device->uin_norm;
+  const size_t nxy = static_cast<size_t>(inres) * inres;
+  amrex::Vector<amrex::Real> uvw[3];
+  if (binfmt) {
+    // Read the u, v, w columns of these planes only
+    amrex::Vector<int> planes;
+    for (int k = 0; k < inres; k++) {
+      if (kmap[k] >= 0) {
+        kmap[k] = planes.size();
+        planes.push_back(k);
+      }
+    }
+    amrex::Vector<amrex::Real> data; /* this needs to be double */
+    read_binary_planes(
+      PeleC::prob_parm_host->iname, inres, inres, inres, 6, planes, {3, 4, 5},
+      data);
+    for (int n = 0; n < 3; n++) {
+      uvw[n].resize(planes.size() * nxy);
+      for (long m = 0; m < uvw[n].size(); m++) {
+        uvw[n][m] = data[n + 3 * m] * scale;
+      }
+    }
+  } else {
+    // The whole csv file was read in amrex_probinit
+    for (int k = 0; k < inres; k++) {
+      kmap[k] = k;
+    }
+    const amrex::Vector<amrex::Real>* h_input[3] = {
+      &PeleC::prob_parm_host->h_uinput, &PeleC::prob_parm_host->h_vinput,
+      &PeleC::prob_parm_host->h_winput};
+    for (int n = 0; n < 3; n++) {
+      uvw[n].resize(h_input[n]->size());
+      for (long m = 0; m < uvw[n].size(); m++) {
+        uvw[n][m] = (*h_input[n])[m] * scale;
+      }
+    }
+  }
+
+  PeleC::prob_parm_host->h_kmap = kmap;
+  amrex::Gpu::DeviceVector<amrex::Real>* d_input[3] = {
+    &PeleC::prob_parm_host->uinput, &PeleC::prob_parm_host->vinput,
+    &PeleC::prob_parm_host->winput};
+  for (int n = 0; n < 3; n++) {
+    d_input[n]->resize(uvw[n].size());
+    amrex::Gpu::copy(
+      amrex::Gpu::hostToDevice, uvw[n].begin(), uvw[n].end(),
+      d_input[n]->begin());
+  }
+  PeleC::prob_parm_host->kmap.resize(kmap.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, kmap.begin(), kmap.end(),
+    PeleC::prob_parm_host->kmap.begin());
+
+  PeleC::h_prob_parm_device->d_uinput = PeleC::prob_parm_host->uinput.data();
+  PeleC::h_prob_parm_device->d_vinput = PeleC::prob_parm_host->vinput.data();
+  PeleC::h_prob_parm_device->d_winput = PeleC::prob_parm_host->winput.data();
+  PeleC::h_prob_parm_device->d_kmap = PeleC::prob_parm_host->kmap.data();
+}
+
 void
 PeleC::problem_post_timestep()
 {
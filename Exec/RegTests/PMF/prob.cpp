@@ -74,39 +74,29 @@ read_pmf(const std::string& myfile)
   }
   amrex::Print() << line_count << " data lines found in PMF file" << std::endl;
 
-  PeleC::h_prob_parm_device->pmf_N = line_count;
-  PeleC::h_prob_parm_device->pmf_M = variable_count - 1;
-  PeleC::prob_parm_host->h_pmf_X.resize(PeleC::h_prob_parm_device->pmf_N);
-  PeleC::prob_parm_host->pmf_X.resize(PeleC::h_prob_parm_device->pmf_N);
-  PeleC::prob_parm_host->h_pmf_Y.resize(
-    PeleC::h_prob_parm_device->pmf_N * PeleC::h_prob_parm_device->pmf_M);
-  PeleC::prob_parm_host->pmf_Y.resize(
-    PeleC::h_prob_parm_device->pmf_N * PeleC::h_prob_parm_device->pmf_M);
+  const int pmf_N = line_count;
+  const int pmf_M = variable_count - 1;
+  amrex::Vector<amrex::Real> pmf_X(pmf_N);
+  amrex::Vector<amrex::Real> pmf_Y(pmf_N * pmf_M);
 
   iss.clear();
   iss.seekg(0, std::ios::beg);
   std::getline(iss, firstline);
   std::getline(iss, secondline);
-  for (unsigned int i = 0; i < PeleC::h_prob_parm_device->pmf_N; i++) {
+  for (int i = 0; i < pmf_N; i++) {
     std::getline(iss, remaininglines);
     std::istringstream sinput(remaininglines);
-    sinput >> PeleC::prob_parm_host->h_pmf_X[i];
-    for (unsigned int j = 0; j < PeleC::h_prob_parm_device->pmf_M; j++) {
-      sinput >> PeleC::prob_parm_host
-                  ->h_pmf_Y[j * PeleC::h_prob_parm_device->pmf_N + i];
+    sinput >> pmf_X[i];
+    for (int j = 0; j < pmf_M; j++) {
+      sinput >> pmf_Y[j * pmf_N + i];
     }
   }
 
-  amrex::Gpu::copy(
-    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_pmf_X.begin(),
-    PeleC::prob_parm_host->h_pmf_X.end(), PeleC::prob_parm_host->pmf_X.begin());
-  amrex::Gpu::copy(
-    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_pmf_Y.begin(),
-    PeleC::prob_parm_host->h_pmf_Y.end(), PeleC::prob_parm_host->pmf_Y.begin());
-  PeleC::h_prob_parm_device->d_pmf_X = PeleC::prob_parm_host->pmf_X.data();
-  PeleC::h_prob_parm_device->d_pmf_Y = PeleC::prob_parm_host->pmf_Y.data();
-  PeleC::d_prob_parm_device->d_pmf_X = PeleC::prob_parm_host->pmf_X.data();
-  PeleC::d_prob_parm_device->d_pmf_Y = PeleC::prob_parm_host->pmf_Y.data();
+  PeleC::prob_parm_host->pmf_table.define(pmf_X, pmf_Y, pmf_M);
+  PeleC::h_prob_parm_device->pmf_table =
+    PeleC::prob_parm_host->pmf_table.data();
+  PeleC::d_prob_parm_device->pmf_table =
+    PeleC::prob_parm_host->pmf_table.data();
 }
 
 void
@@ -199,6 +189,11 @@ amrex_probinit(
 }
 }
 
+void
+PeleC::problem_pre_init_data()
+{
+}
+
 void
 PeleC::problem_post_timestep()
 {
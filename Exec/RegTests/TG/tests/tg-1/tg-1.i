@@ -66,3 +66,21 @@ prob.prandtl = 0.71
 # EB
 eb2.geom_type = "all_regular"
 ebd.boundary_grad_stencil_type = 0
+
+# IN-SITU SAMPLING
+sampling.int = 10
+sampling.labels = center axis midplane
+sampling.center.type = probes
+sampling.center.fields = density Temp x_velocity
+sampling.center.locations = 0.0 0.0 0.0  0.5 -0.5 0.25
+sampling.axis.type = line
+sampling.axis.fields = x_velocity pressure
+sampling.axis.start = -0.99 0.0 0.0
+sampling.axis.end = 0.99 0.0 0.0
+sampling.axis.num_points = 64
+sampling.midplane.type = plane
+sampling.midplane.fields = density x_velocity
+sampling.midplane.origin = -0.99 -0.99 0.0
+sampling.midplane.axis1 = 1.98 0.0 0.0
+sampling.midplane.axis2 = 0.0 1.98 0.0
+sampling.midplane.num_points = 16 16
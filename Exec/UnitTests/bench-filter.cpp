@@ -0,0 +1,88 @@
+/** \file bench-filter.cpp
+ *
+ *  Times the separable explicit filter against the tensor-product kernel
+ *  for every filter type. Disabled in the unit tests, run by the
+ *  filter-bench performance test through Tests/benchmark.py.
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_FArrayBox.H"
+#include "AMReX_Gpu.H"
+#include "AMReX_ParallelDescriptor.H"
+
+#include "Filter.H"
+
+namespace pelec_tests {
+
+namespace {
+
+const char* const filter_names[num_filter_types] = {
+  "no_filter",
+  "box",
+  "gaussian",
+  "box_3pt_approx",
+  "box_5pt_approx",
+  "box_3pt_optimized_approx",
+  "box_5pt_optimized_approx",
+  "gaussian_3pt_approx",
+  "gaussian_5pt_approx",
+  "gaussian_3pt_optimized_approx",
+  "gaussian_5pt_optimized_approx"};
+
+// Wall time of nrep calls of f, after one untimed call
+template <typename F>
+amrex::Real
+time_filter(const int nrep, F&& f)
+{
+  f();
+  amrex::Gpu::streamSynchronize();
+  const amrex::Real t0 = amrex::ParallelDescriptor::second();
+  for (int r = 0; r < nrep; r++) {
+    f();
+  }
+  amrex::Gpu::streamSynchronize();
+  return amrex::ParallelDescriptor::second() - t0;
+}
+
+} // namespace
+
+// cppcheck-suppress missingOverride
+TEST(FilterBenchmark, DISABLED_SeparableVsTensor)
+{
+  const int ncomp = 5;
+  const int nrep = 10;
+  const amrex::Box bx(amrex::IntVect(0), amrex::IntVect(63));
+
+  RecordProperty("cells", static_cast<long>(bx.numPts()));
+  RecordProperty("ncomp", ncomp);
+  RecordProperty("nrep", nrep);
+
+  for (int fgr : {2, 4}) {
+    for (int type = 0; type < num_filter_types; type++) {
+      Filter filter(type, fgr);
+      const int ng = filter.get_filter_ngrow();
+
+      amrex::FArrayBox in(amrex::grow(bx, ng), ncomp);
+      amrex::FArrayBox out(bx, ncomp);
+      auto const& q = in.array();
+      amrex::ParallelFor(
+        in.box(), ncomp,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+          q(i, j, k, n) = std::sin(0.3 * i + n) * std::cos(0.2 * j - 0.5 * k);
+        });
+
+      const amrex::Real t_separable = time_filter(
+        nrep, [&]() { filter.apply_filter(bx, in, out, 0, ncomp); });
+      const amrex::Real t_tensor = time_filter(
+        nrep, [&]() { filter.apply_filter_tensor(bx, in, out, 0, ncomp); });
+
+      // benchmark.py reads the time_ properties as timed regions
+      const std::string key = std::string("time_") + filter_names[type] +
+                              "_fgr" + std::to_string(fgr);
+      RecordProperty(key + "_separable", t_separable);
+      RecordProperty(key + "_tensor", t_tensor);
+    }
+  }
+}
+
+} // namespace pelec_tests
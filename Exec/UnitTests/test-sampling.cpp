@@ -0,0 +1,61 @@
+/** \file test-sampling.cpp
+ *
+ *  Checks the interpolation of the in-situ samplers, which is exact for
+ *  fields linear in each direction
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_FArrayBox.H"
+#include "AMReX_Gpu.H"
+
+#include "Sampling.H"
+
+namespace pelec_tests {
+
+// cppcheck-suppress missingOverride
+TEST(Sampling, InterpolationExactForLinearFields)
+{
+  const int ncomp = 2;
+  const amrex::Box bx(amrex::IntVect(-1), amrex::IntVect(8));
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> plo = {
+    {AMREX_D_DECL(-1.0, 0.5, 2.0)}};
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = {
+    {AMREX_D_DECL(0.25, 0.5, 0.125)}};
+  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxinv;
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    dxinv[d] = 1.0 / dx[d];
+  }
+
+  // Component n is 1 + (n+1) x - 2 y + 3 z at the cell centers
+  auto exact = [=](const amrex::Real* x, const int n) {
+    const amrex::Real c[3] = {n + 1.0, -2.0, 3.0};
+    amrex::Real v = 1.0;
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      v += c[d] * x[d];
+    }
+    return v;
+  };
+  amrex::FArrayBox fab(bx, ncomp, amrex::The_Pinned_Arena());
+  auto const& a = fab.array();
+  amrex::LoopOnCpu(bx, ncomp, [&](int i, int j, int k, int n) noexcept {
+    const int iv[3] = {i, j, k};
+    amrex::Real x[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      x[d] = plo[d] + (iv[d] + 0.5) * dx[d];
+    }
+    a(i, j, k, n) = exact(x, n);
+  });
+
+  // Points between cell centers, on a cell center and on a face
+  const amrex::Real pts[3][3] = {
+    {0.13, 1.37, 2.41}, {-0.875, 0.75, 2.0625}, {0.5, 2.0, 2.5}};
+  for (const auto& p : pts) {
+    for (int n = 0; n < ncomp; n++) {
+      const amrex::Real v =
+        pc_sample_interp(p, plo, dxinv, fab.const_array(), n);
+      EXPECT_NEAR(v, exact(p, n), 1.0e-12) << "component " << n;
+    }
+  }
+}
+
+} // namespace pelec_tests
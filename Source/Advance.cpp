@@ -29,6 +29,10 @@ PeleC::advance(
     }
   }
 
+#ifdef AMREX_USE_GPU
+  const amrex::Real wt = amrex::ParallelDescriptor::second();
+#endif
+
   amrex::Real dt_new;
   if (do_mol) {
     dt_new = do_mol_advance(time, dt, amr_iteration, amr_ncycle);
@@ -36,22 +40,58 @@ PeleC::advance(
     dt_new = do_sdc_advance(time, dt, amr_iteration, amr_ncycle);
   }
 
+#ifdef AMREX_USE_GPU
+  // The tiles added fixed per-cell costs, rescale them to this advance
+  if (do_mol_load_balance || do_react_load_balance) {
+    amrex::Gpu::streamSynchronize();
+    scale_work_estimate(amrex::ParallelDescriptor::second() - wt);
+  }
+#endif
+
+  // The state changes after the advance (reflux, average down)
+  Sborder_ngrow = -1;
+
   return dt_new;
 }
 
+void
+PeleC::fillSborder(amrex::Real time, int ng)
+{
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::FillPatch);
+  if (do_les) {
+    ng = std::max(ng, nGrowLES());
+  }
+  FillPatch(*this, Sborder, ng, time, State_Type, 0, NVAR);
+  Sborder_time = time;
+  Sborder_ngrow = ng;
+}
+
+const amrex::MultiFab*
+PeleC::filledState(amrex::Real time, int ng) const
+{
+  const amrex::Real eps =
+    1.0e-12 * amrex::max<amrex::Real>(1.0, std::abs(time));
+  if (Sborder_ngrow >= ng && std::abs(time - Sborder_time) <= eps) {
+    return &Sborder;
+  }
+  return nullptr;
+}
+
 amrex::Real
 PeleC::do_mol_advance(
   amrex::Real time, amrex::Real dt, int amr_iteration, int amr_ncycle)
 {
   BL_PROFILE("PeleC::do_mol_advance()");
 
+  Sborder_ngrow = -1;
+
   // Check that we are not asking to advance stuff we don't know to
   // if (src_list.size() > 0) amrex::Abort("Have not integrated other sources
   // into MOL advance yet");
 
   for (int i = 0; i < num_state_type; ++i) {
 #ifdef PELEC_USE_REACTIONS
-    if (!(i == Reactions_Type && do_react)) {
+    if (!((i == Reactions_Type || i == Chem_Dt_Type) && do_react)) {
 #endif
       state[i].allocOldData();
       state[i].swapTimeLevels(dt);
@@ -95,9 +135,14 @@ PeleC::do_mol_advance(
   if (verbose) {
     amrex::Print() << "... Computing MOL source term at t^{n} " << std::endl;
   }
-  FillPatch(*this, Sborder, numGrow() + nGrowF, time, State_Type, 0, NVAR);
+  // The MOL source fuses hydro and diffusion
+  const int mol_phase = do_hydro ? PerfLog::Hydro : PerfLog::Diffusion;
+  fillSborder(time, numGrow() + nGrowF);
   amrex::Real flux_factor = 0;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  {
+    PerfLogTimer perf_timer(perf_log, level, mol_phase);
+    getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  }
 
   // Build other (neither spray nor diffusion) sources at t_old
   for (int n = 0; n < src_list.size(); ++n) {
@@ -137,9 +182,12 @@ PeleC::do_mol_advance(
   if (verbose) {
     amrex::Print() << "... Computing MOL source term at t^{n+1} " << std::endl;
   }
-  FillPatch(*this, Sborder, numGrow() + nGrowF, time + dt, State_Type, 0, NVAR);
+  fillSborder(time + dt, numGrow() + nGrowF);
   flux_factor = mol_iters > 1 ? 0 : 1;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  {
+    PerfLogTimer perf_timer(perf_log, level, mol_phase);
+    getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  }
 
   // Build other (neither spray nor diffusion) sources at t_new
   for (int n = 0; n < src_list.size(); ++n) {
@@ -191,10 +239,12 @@ PeleC::do_mol_advance(
         amrex::Print() << "... Re-computing MOL source term at t^{n+1} (iter = "
                        << mol_iter << " of " << mol_iters << ")" << std::endl;
       }
-      FillPatch(
-        *this, Sborder, numGrow() + nGrowF, time + dt, State_Type, 0, NVAR);
+      fillSborder(time + dt, numGrow() + nGrowF);
       flux_factor = mol_iter == mol_iters ? 1 : 0;
-      getMOLSrcTerm(Sborder, molSrc_new, time, dt, flux_factor);
+      {
+        PerfLogTimer perf_timer(perf_log, level, mol_phase);
+        getMOLSrcTerm(Sborder, molSrc_new, time, dt, flux_factor);
+      }
 
       // F_{AD} = (1/2)(molSrc_old + molSrc_new)
       amrex::MultiFab::LinComb(
@@ -295,7 +345,7 @@ PeleC::do_sdc_advance(
 
   initialize_sdc_advance(time, dt, amr_iteration, amr_ncycle);
 
-  if (do_react_load_balance) {
+  if (do_mol_load_balance || do_react_load_balance) {
     get_new_data(Work_Estimate_Type).setVal(0.0);
   }
 
@@ -329,6 +379,9 @@ PeleC::do_sdc_iteration(
 
   BL_PROFILE("PeleC::do_sdc_iteration()");
 
+  // S_new changed since the previous iteration filled Sborder
+  Sborder_ngrow = -1;
+
   const amrex::MultiFab& S_old = get_old_data(State_Type);
   amrex::MultiFab& S_new = get_new_data(State_Type);
 
@@ -376,7 +429,7 @@ PeleC::do_sdc_iteration(
 #endif
 
   if (fill_Sborder) {
-    FillPatch(*this, Sborder, nGrow_Sborder, time, State_Type, 0, NVAR);
+    fillSborder(time, nGrow_Sborder);
   }
 
   if (sub_iteration == 0) {
@@ -387,6 +440,7 @@ PeleC::do_sdc_iteration(
     // TODO: Maybe move this mess into construct_old_source?
     if (do_spray_particles) {
       amrex::Gpu::LaunchSafeGuard lsg(true);
+      const amrex::Real wt = amrex::ParallelDescriptor::second();
 
       // Setup ghost particles for use in finer levels. Note that ghost
       // particles that will be used by this level have already been created,
@@ -453,6 +507,10 @@ PeleC::do_sdc_iteration(
         theGhostPC()->moveKickDrift(
           Sborder, *old_sources[spray_src], level, dt, cur_time, false, true,
           tmp_src_width, true, where_width);
+
+      if (do_mol_load_balance) {
+        add_spray_work_estimate(amrex::ParallelDescriptor::second() - wt);
+      }
     }
 #endif
 
@@ -480,6 +538,7 @@ PeleC::do_sdc_iteration(
         !do_mol); // Currently this combo only managed through MOL integrator
       amrex::Real flux_factor_old = 0.5;
 
+      PerfLogTimer perf_timer(perf_log, level, PerfLog::Diffusion);
       getMOLSrcTerm(Sborder, *old_sources[diff_src], time, dt, flux_factor_old);
     }
 
@@ -492,6 +551,7 @@ PeleC::do_sdc_iteration(
 
   // Construct hydro source, will use old and current iterate of new sources.
   if (do_hydro) {
+    PerfLogTimer perf_timer(perf_log, level, PerfLog::Hydro);
     construct_hydro_source(
       Sborder, time, dt, amr_iteration, amr_ncycle, sub_iteration, sub_ncycle);
   }
@@ -509,8 +569,9 @@ PeleC::do_sdc_iteration(
       amrex::Print() << "... Computing diffusion terms at t^(n+1,"
                      << sub_iteration + 1 << ")" << std::endl;
     }
-    FillPatch(*this, Sborder, numGrow(), time + dt, State_Type, 0, NVAR);
+    fillSborder(time + dt, numGrow());
     amrex::Real flux_factor_new = sub_iteration == sub_ncycle - 1 ? 0.5 : 0;
+    PerfLogTimer perf_timer(perf_log, level, PerfLog::Diffusion);
     getMOLSrcTerm(Sborder, *new_sources[diff_src], time, dt, flux_factor_new);
   }
 
@@ -535,9 +596,10 @@ PeleC::do_sdc_iteration(
       amrex::Print() << "moveKick ... updating velocity only\n";
 
     if (!do_diffuse) { // Else, this was already done above.  No need to redo
-      FillPatch(*this, Sborder, nGrow_Sborder, time + dt, State_Type, 0, NVAR);
+      fillSborder(time + dt, nGrow_Sborder);
     }
 
+    const amrex::Real wt = amrex::ParallelDescriptor::second();
     new_sources[spray_src]->setVal(0.);
 
     theSprayPC()->moveKick(
@@ -552,6 +614,10 @@ PeleC::do_sdc_iteration(
       theGhostPC()->moveKick(
         Sborder, *new_sources[spray_src], level, dt, time + dt, false, true,
         tmp_src_width);
+
+    if (do_mol_load_balance) {
+      add_spray_work_estimate(amrex::ParallelDescriptor::second() - wt);
+    }
   }
 #endif
 
@@ -656,6 +722,8 @@ PeleC::initialize_sdc_advance(
       get_new_data(Reactions_Type), get_old_data(Reactions_Type), 0, 0,
       get_new_data(Reactions_Type).nComp(),
       get_new_data(Reactions_Type).nGrow());
+    amrex::MultiFab::Copy(
+      get_new_data(Chem_Dt_Type), get_old_data(Chem_Dt_Type), 0, 0, 1, 0);
   }
 #endif
 }
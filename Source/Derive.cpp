@@ -1,3 +1,5 @@
+#include <map>
+
 #include "mechanism.H"
 
 #include "PelePhysics.H"
@@ -675,6 +677,106 @@ pc_dercv(
   });
 }
 
+int
+pc_plot_prim_derive(const std::string& name)
+{
+  static const std::map<std::string, int> ids = {
+    {"x_velocity", PPD_XVEL}, {"y_velocity", PPD_YVEL},
+    {"z_velocity", PPD_ZVEL}, {"magvel", PPD_MAGVEL},
+    {"kineng", PPD_KINENG},   {"pressure", PPD_PRES},
+    {"soundspeed", PPD_SOUNDSPEED}, {"MachNumber", PPD_MACH}};
+  const auto it = ids.find(name);
+  return it == ids.end() ? -1 : it->second;
+}
+
+bool
+pc_plot_prim_needs_eos(const int id)
+{
+  return id == PPD_PRES || id == PPD_SOUNDSPEED || id == PPD_MACH;
+}
+
+void
+pc_derplotprim(
+  const amrex::Box& bx,
+  amrex::FArrayBox& primfab,
+  const amrex::FArrayBox& datfab,
+  const bool with_eos)
+{
+  auto const dat = datfab.const_array();
+  auto prim = primfab.array();
+
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::Real rho = dat(i, j, k, URHO);
+    const amrex::Real rhoInv = 1.0 / rho;
+    prim(i, j, k, PP_U) = dat(i, j, k, UMX) * rhoInv;
+    prim(i, j, k, PP_V) = dat(i, j, k, UMY) * rhoInv;
+    prim(i, j, k, PP_W) = dat(i, j, k, UMZ) * rhoInv;
+    if (with_eos) {
+      const amrex::Real T = dat(i, j, k, UTEMP);
+      amrex::Real massfrac[NUM_SPECIES];
+      for (int n = 0; n < NUM_SPECIES; ++n) {
+        massfrac[n] = dat(i, j, k, UFS + n) * rhoInv;
+      }
+      amrex::Real p;
+      amrex::Real c;
+      auto eos = pele::physics::PhysicsType::eos();
+      eos.RTY2P(rho, T, massfrac, p);
+      eos.RTY2Cs(rho, T, massfrac, c);
+      prim(i, j, k, PP_P) = p;
+      prim(i, j, k, PP_C) = c;
+    }
+  });
+}
+
+void
+pc_derfromprim(
+  const amrex::Box& bx,
+  amrex::FArrayBox& derfab,
+  int dcomp,
+  const amrex::FArrayBox& primfab,
+  const amrex::FArrayBox& datfab,
+  const int id)
+{
+  auto const dat = datfab.const_array();
+  auto const prim = primfab.const_array();
+  auto der = derfab.array(dcomp);
+
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::Real u = prim(i, j, k, PP_U);
+    const amrex::Real v = prim(i, j, k, PP_V);
+    const amrex::Real w = prim(i, j, k, PP_W);
+    const amrex::Real usq = u * u + v * v + w * w;
+    switch (id) {
+    case PPD_XVEL:
+      der(i, j, k) = u;
+      break;
+    case PPD_YVEL:
+      der(i, j, k) = v;
+      break;
+    case PPD_ZVEL:
+      der(i, j, k) = w;
+      break;
+    case PPD_MAGVEL:
+      der(i, j, k) = std::sqrt(usq);
+      break;
+    case PPD_KINENG:
+      der(i, j, k) = 0.5 * dat(i, j, k, URHO) * usq;
+      break;
+    case PPD_PRES:
+      der(i, j, k) = prim(i, j, k, PP_P);
+      break;
+    case PPD_SOUNDSPEED:
+      der(i, j, k) = prim(i, j, k, PP_C);
+      break;
+    case PPD_MACH:
+      der(i, j, k) = std::sqrt(usq) / prim(i, j, k, PP_C);
+      break;
+    default:
+      break;
+    }
+  });
+}
+
 #ifdef PELEC_USE_MASA
 void
 pc_derrhommserror(
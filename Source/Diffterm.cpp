@@ -22,7 +22,7 @@ pc_compute_diffusion_flux(
   ,
   const amrex::FabType typ,
   const int Ncut,
-  const EBBndryGeom* ebg,
+  const EBBndryView& ebg,
   const amrex::Array4<amrex::EBCellFlag const>& flags
 #endif
 )
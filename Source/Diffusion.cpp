@@ -89,11 +89,6 @@ PeleC::getMOLSrcTerm(
     dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
   auto const& flags = fact.getMultiEBCellFlagFab();
   // amrex::Elixir flags_eli = flags.elixir();
-  amrex::MultiFab* cost = nullptr;
-
-  if (do_mol_load_balance) {
-    cost = &(get_new_data(Work_Estimate_Type));
-  }
 
   amrex::EBFluxRegister* fr_as_crse = nullptr;
   if (do_reflux && level < parent->finestLevel()) {
@@ -126,21 +121,22 @@ PeleC::getMOLSrcTerm(
     for (amrex::MFIter mfi(MOLSrcTerm, amrex::TilingIfNotGPU()); mfi.isValid();
          ++mfi) {
       const amrex::Box vbox = mfi.tilebox();
-      int ng = S.nGrow();
+      // S may have extra grow cells for the LES
+      int ng = std::min(S.nGrow(), numGrow() + nGrowF);
       const amrex::Box gbox = amrex::grow(vbox, ng);
       const amrex::Box cbox = amrex::grow(vbox, ng - 1);
       auto const& MOLSrc = MOLSrcTerm.array(mfi);
 
+      const amrex::Real wt = amrex::ParallelDescriptor::second();
+
 #ifdef PELEC_USE_EB
-      amrex::Real wt = amrex::ParallelDescriptor::second();
       const auto& flag_fab = flags[mfi];
       // amrex::Elixir flag_fab_eli = flag_fab.elixir();
       amrex::FabType typ = flag_fab.getType(vbox);
       if (typ == amrex::FabType::covered) {
         setV(vbox, NVAR, MOLSrc, 0);
-        if (do_mol_load_balance && cost) {
-          wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-          (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+        if (do_mol_load_balance) {
+          add_work_estimate(mfi, vbox, wt);
         }
         continue;
       }
@@ -155,13 +151,13 @@ PeleC::getMOLSrcTerm(
       const amrex::Box ebfluxbox = amrex::grow(vbox, 2);
 
       int local_i = mfi.LocalIndex();
-      int Ncut = (!eb_in_domain) ? 0 : sv_eb_bndry_grad_stencil[local_i].size();
-      SparseData<amrex::Real, EBBndrySten> eb_flux_thdlocal;
+      const EBBoxStencils& ebs = *eb_stencils[local_i];
+      const EBBndryView& ebg = ebs.bndry.view();
+      int Ncut = (!eb_in_domain) ? 0 : ebs.bndry.size();
+      SparseData<amrex::Real> eb_flux_thdlocal;
       if (Ncut > 0) {
-        eb_flux_thdlocal.define(sv_eb_bndry_grad_stencil[local_i], NVAR);
+        eb_flux_thdlocal.define(Ncut, NVAR);
       }
-      auto* d_sv_eb_bndry_geom =
-        (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : nullptr);
 #endif
 
       // const int* lo = vbox.loVect();
@@ -169,12 +165,9 @@ PeleC::getMOLSrcTerm(
 
       BL_PROFILE_VAR_START(diff);
       int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR);
-      amrex::FArrayBox qaux(gbox, nqaux);
-      amrex::FArrayBox coeff_cc(gbox, nCompTr);
-      amrex::Elixir qeli = q.elixir();
-      amrex::Elixir qauxeli = qaux.elixir();
-      amrex::Elixir coefeli = coeff_cc.elixir();
+      ScratchFab q(scratch_pool, gbox, QVAR);
+      ScratchFab qaux(scratch_pool, gbox, nqaux);
+      ScratchFab coeff_cc(scratch_pool, gbox, nCompTr);
       auto const& sar = S.array(mfi);
       auto const& qar = q.array();
       auto const& qauxar = qaux.array();
@@ -246,8 +239,7 @@ PeleC::getMOLSrcTerm(
         });
       }
 
-      amrex::FArrayBox flux_ec[AMREX_SPACEDIM];
-      amrex::Elixir flux_eli[AMREX_SPACEDIM];
+      ScratchFab flux_ec[AMREX_SPACEDIM];
       const amrex::Box eboxes[AMREX_SPACEDIM] = {AMREX_D_DECL(
         amrex::surroundingNodes(cbox, 0), amrex::surroundingNodes(cbox, 1),
         amrex::surroundingNodes(cbox, 2))};
@@ -257,14 +249,12 @@ PeleC::getMOLSrcTerm(
         area_arr{{AMREX_D_DECL(
           area[0].array(mfi), area[1].array(mfi), area[2].array(mfi))}};
       for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-        flux_ec[dir].resize(eboxes[dir], NVAR);
-        flux_eli[dir] = flux_ec[dir].elixir();
+        flux_ec[dir].define(scratch_pool, eboxes[dir], NVAR);
         flx[dir] = flux_ec[dir].array();
         setV(eboxes[dir], NVAR, flx[dir], 0);
       }
 
-      amrex::FArrayBox Dfab(cbox, NVAR);
-      amrex::Elixir Dfab_eli = Dfab.elixir();
+      ScratchFab Dfab(scratch_pool, cbox, NVAR);
       auto const& Dterm = Dfab.array();
       setV(cbox, NVAR, Dterm, 0.0);
 
@@ -272,7 +262,7 @@ PeleC::getMOLSrcTerm(
         cbox, qar, coe_cc, flx, area_arr, dx, do_harmonic
 #ifdef PELEC_USE_EB
         ,
-        typ, Ncut, d_sv_eb_bndry_geom, flags.array(mfi)
+        typ, Ncut, ebg, flags.array(mfi)
 #endif
       );
 
@@ -332,9 +322,9 @@ PeleC::getMOLSrcTerm(
           {
             BL_PROFILE("PeleC::pc_apply_eb_boundry_flux_stencil()");
             pc_apply_eb_boundry_flux_stencil(
-              ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut, qar,
-              QTEMP, coe_cc, dComp_lambda, sv_eb_bcval[local_i].dataPtr(QTEMP),
-              Nvals, eb_flux_thdlocal.dataPtr(Eden), nFlux, 1);
+              ebfluxbox, ebg, qar, QTEMP, coe_cc, dComp_lambda,
+              sv_eb_bcval[local_i].dataPtr(QTEMP), Nvals,
+              eb_flux_thdlocal.dataPtr(Eden), nFlux, 1);
           }
         }
         // Compute momentum transfer at no-slip EB wall
@@ -342,10 +332,8 @@ PeleC::getMOLSrcTerm(
           {
             BL_PROFILE("PeleC::pc_apply_eb_boundry_visc_flux_stencil()");
             pc_apply_eb_boundry_visc_flux_stencil(
-              ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut,
-              d_sv_eb_bndry_geom, Ncut, qar, coe_cc,
-              sv_eb_bcval[local_i].dataPtr(QU), Nvals,
-              eb_flux_thdlocal.dataPtr(Xmom), nFlux);
+              ebfluxbox, ebg, qar, coe_cc, sv_eb_bcval[local_i].dataPtr(QU),
+              Nvals, eb_flux_thdlocal.dataPtr(Xmom), nFlux);
           }
         }
       }
@@ -368,14 +356,13 @@ PeleC::getMOLSrcTerm(
 
         // save off the diffusion source term and fluxes (don't want to filter
         // these)
-        amrex::FArrayBox diffusion_flux[AMREX_SPACEDIM];
-        amrex::Elixir diffusion_flux_eli[AMREX_SPACEDIM];
+        ScratchFab diffusion_flux[AMREX_SPACEDIM];
         amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
           diffusion_flux_arr;
         if (use_explicit_filter) {
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            diffusion_flux[dir].resize(flux_ec[dir].box(), NVAR);
-            diffusion_flux_eli[dir] = diffusion_flux[dir].elixir();
+            diffusion_flux[dir].define(
+              scratch_pool, flux_ec[dir].box(), NVAR);
             diffusion_flux_arr[dir] = diffusion_flux[dir].array();
             copy_array4(
               flux_ec[dir].box(), flux_ec[dir].nComp(), flx[dir],
@@ -392,11 +379,10 @@ PeleC::getMOLSrcTerm(
 #endif
           // auto const& vol = volume.array(mfi);
           pc_compute_hyp_mol_flux(
-            cbox, qar, qauxar, flx, area_arr, dx, plm_iorder
+            cbox, qar, qauxar, flx, area_arr, dx, plm_iorder, mol_fused_flux
 #ifdef PELEC_USE_EB
             ,
-            flags.array(mfi), d_sv_eb_bndry_geom, Ncut, d_eb_flux_thdlocal,
-            nFlux
+            flags.array(mfi), ebg, Ncut, d_eb_flux_thdlocal, nFlux
 #endif
           );
         }
@@ -404,13 +390,11 @@ PeleC::getMOLSrcTerm(
         // Filter hydro source term and fluxes here
         if (use_explicit_filter) {
           // Get the hydro term
-          amrex::FArrayBox hydro_flux[AMREX_SPACEDIM];
-          amrex::Elixir hydro_flux_eli[AMREX_SPACEDIM];
+          ScratchFab hydro_flux[AMREX_SPACEDIM];
           amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
             hydro_flux_arr;
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            hydro_flux[dir].resize(flux_ec[dir].box(), NVAR);
-            hydro_flux_eli[dir] = hydro_flux[dir].elixir();
+            hydro_flux[dir].define(scratch_pool, flux_ec[dir].box(), NVAR);
             hydro_flux_arr[dir] = hydro_flux[dir].array();
             lincomb_array4(
               flux_ec[dir].box(), Density, NVAR, flx[dir],
@@ -421,10 +405,7 @@ PeleC::getMOLSrcTerm(
           const amrex::Box fbox = amrex::grow(cbox, -nGrowF);
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
             const amrex::Box& bxtmp = amrex::surroundingNodes(fbox, dir);
-            amrex::FArrayBox filtered_hydro_flux;
-            filtered_hydro_flux.resize(bxtmp, NVAR);
-            amrex::Elixir filtered_hydro_flux_eli =
-              filtered_hydro_flux.elixir();
+            ScratchFab filtered_hydro_flux(scratch_pool, bxtmp, NVAR);
             les_filter.apply_filter(
               bxtmp, hydro_flux[dir], filtered_hydro_flux, Density, NVAR);
 
@@ -465,7 +446,7 @@ PeleC::getMOLSrcTerm(
       amrex::Gpu::DeviceVector<int> v_eb_tile_mask(Ncut, 0);
       int* eb_tile_mask = v_eb_tile_mask.dataPtr();
       amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int icut) {
-        if (ebfluxbox.contains(d_sv_eb_bndry_geom[icut].iv)) {
+        if (ebfluxbox.contains(ebg.iv[icut])) {
           eb_tile_mask[icut] = 1;
         }
       });
@@ -488,14 +469,14 @@ PeleC::getMOLSrcTerm(
         {
           BL_PROFILE("PeleC::pc_apply_face_stencil()");
           for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
-            int Nsten = flux_interp_stencil[dir][local_i].size();
+            int Nsten = ebs.flux_interp_stencil[dir].size();
             // int in_place = 1;
             const amrex::Box valid_interped_flux_box =
               amrex::Box(ebfluxbox).surroundingNodes(dir);
             if (Nsten > 0) {
               pc_apply_face_stencil(
                 valid_interped_flux_box, stencil_volume_box,
-                flux_interp_stencil[dir][local_i].data(), Nsten, dir, NVAR,
+                ebs.flux_interp_stencil[dir].data(), Nsten, dir, NVAR,
                 flx[dir]);
             }
           }
@@ -534,8 +515,7 @@ PeleC::getMOLSrcTerm(
           if (Ncut > 0) {
             BL_PROFILE("PeleC::pc_eb_div()");
             pc_eb_div(
-              vbox, vol, NVAR, d_sv_eb_bndry_geom, Ncut,
-              AMREX_D_DECL(flx[0], flx[1], flx[2]),
+              vbox, vol, NVAR, ebg, AMREX_D_DECL(flx[0], flx[1], flx[2]),
               sv_eb_flux[local_i].dataPtr(), vfrac.array(mfi), Dterm);
           }
         }
@@ -644,15 +624,13 @@ PeleC::getMOLSrcTerm(
                      , auto fcz = fact.getFaceCent()[2]->const_array(mfi););
         auto ccc = fact.getCentroid().const_array(mfi);
 
-        amrex::FArrayBox tmpfab(Dfab.box(), S.nComp());
+        ScratchFab tmpfab(scratch_pool, Dfab.box(), S.nComp());
         if (redistribution_type == "FluxRedist") {
           tmpfab.setVal<amrex::RunOn::Device>(1.0);
         }
-        amrex::Elixir tmpeli = tmpfab.elixir();
         amrex::Array4<amrex::Real> scratch = tmpfab.array();
 
-        amrex::FArrayBox Dterm_tmpfab(Dfab.box(), S.nComp());
-        amrex::Elixir Dterm_tmpeli = Dterm_tmpfab.elixir();
+        ScratchFab Dterm_tmpfab(scratch_pool, Dfab.box(), S.nComp());
         amrex::Array4<amrex::Real> Dterm_tmp = Dterm_tmpfab.array();
         copy_array4(Dfab.box(), NVAR, Dterm, Dterm_tmp);
 
@@ -678,13 +656,9 @@ PeleC::getMOLSrcTerm(
 
       copy_array4(vbox, NVAR, Dterm, MOLSrc);
 
-#ifdef PELEC_USE_EB
-      if (do_mol_load_balance && cost) {
-        amrex::Gpu::streamSynchronize();
-        wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-        (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+      if (do_mol_load_balance) {
+        add_work_estimate(mfi, vbox, wt);
       }
-#endif
     }
   }
 }
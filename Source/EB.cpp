@@ -1,3 +1,5 @@
+#include <AMReX_Scan.H>
+
 #include "EB.H"
 
 void
@@ -398,6 +400,96 @@ pc_fill_bndry_grad_stencil_ls(
   });
 }
 
+void
+EBBndryData::define(
+  const EBBndryGeom* ebg, const EBBndrySten* sten, const int ncut)
+{
+  m_view = EBBndryView();
+  if (ncut == 0) {
+    return;
+  }
+  m_iv.resize(ncut);
+  m_geom.resize((AMREX_SPACEDIM + 1) * ncut);
+  m_iv_base.resize(ncut);
+  m_bcval_sten.resize(ncut);
+  m_start.resize(ncut + 1);
+
+  // Row starts from the number of nonzero weights of each cell
+  int* start = m_start.data();
+  const int nnz = amrex::Scan::PrefixSum<int>(
+    ncut,
+    [=] AMREX_GPU_DEVICE(int L) -> int {
+      int r = 0;
+      for (int ii = 0; ii < 3; ii++) {
+        for (int jj = 0; jj < 3; jj++) {
+#if AMREX_SPACEDIM > 2
+          for (int kk = 0; kk < 3; kk++) {
+#endif
+            if (sten[L].val PELEC_D_TERM_REVERSE([kk], [jj], [ii]) != 0.0) {
+              r++;
+            }
+#if AMREX_SPACEDIM > 2
+          }
+#endif
+        }
+      }
+      return r;
+    },
+    [=] AMREX_GPU_DEVICE(int L, int const& x) { start[L] = x; },
+    amrex::Scan::Type::exclusive);
+  m_offset.resize(nnz);
+  m_w.resize(nnz);
+
+  // Keep the loop order of the full stencils so that the sums are unchanged
+  amrex::IntVect* iv = m_iv.data();
+  amrex::Real* geom = m_geom.data();
+  amrex::IntVect* iv_base = m_iv_base.data();
+  amrex::Real* bcval_sten = m_bcval_sten.data();
+  unsigned char* offset = m_offset.data();
+  amrex::Real* w = m_w.data();
+  amrex::ParallelFor(ncut, [=] AMREX_GPU_DEVICE(int L) {
+    iv[L] = ebg[L].iv;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      geom[dir * ncut + L] = ebg[L].eb_normal[dir];
+    }
+    geom[AMREX_SPACEDIM * ncut + L] = ebg[L].eb_area;
+    iv_base[L] = sten[L].iv_base;
+    bcval_sten[L] = sten[L].bcval_sten;
+    int m = start[L];
+    for (int ii = 0; ii < 3; ii++) {
+      for (int jj = 0; jj < 3; jj++) {
+#if AMREX_SPACEDIM > 2
+        for (int kk = 0; kk < 3; kk++) {
+#endif
+          const amrex::Real val =
+            sten[L].val PELEC_D_TERM_REVERSE([kk], [jj], [ii]);
+          if (val != 0.0) {
+            offset[m] = AMREX_D_TERM(ii, +3 * jj, +9 * kk);
+            w[m] = val;
+            m++;
+          }
+#if AMREX_SPACEDIM > 2
+        }
+#endif
+      }
+    }
+    if (L == ncut - 1) {
+      start[ncut] = m;
+    }
+  });
+  // The sources are usually temporaries of the caller
+  amrex::Gpu::streamSynchronize();
+
+  m_view.ncut = ncut;
+  m_view.iv = iv;
+  m_view.geom = geom;
+  m_view.iv_base = iv_base;
+  m_view.bcval_sten = bcval_sten;
+  m_view.start = start;
+  m_view.offset = offset;
+  m_view.w = w;
+}
+
 void
 pc_fill_flux_interp_stencil(
   const amrex::Box& bx,
@@ -517,8 +609,7 @@ pc_eb_div(
   const amrex::Box& bx,
   const amrex::Real vol,
   const int nc,
-  const EBBndryGeom* sv_ebg,
-  const int Ncut,
+  const EBBndryView& ebb,
   AMREX_D_DECL(
     const amrex::Array4<const amrex::Real>& f0,
     const amrex::Array4<const amrex::Real>& f1,
@@ -530,12 +621,13 @@ pc_eb_div(
   const auto lo = amrex::lbound(bx);
   const auto hi = amrex::ubound(bx);
   const amrex::Real volinv = 1.0 / vol;
+  const int Ncut = ebb.ncut;
 
   for (int n = 0; n < nc; n++) {
     // Recompute conservative divergence, DC, on cut cells...need DC in 2 grow
     // cells for final result
     amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const auto& iv = sv_ebg[L].iv;
+      const amrex::IntVect iv = ebb.iv[L];
       if (is_inside(iv, lo, hi, 2)) {
         const amrex::Real kappa_inv =
           1.0 / amrex::max<amrex::Real>(vf(iv), 1.0e-12);
@@ -559,10 +651,7 @@ pc_eb_div(
 void
 pc_apply_eb_boundry_visc_flux_stencil(
   const amrex::Box& bx,
-  const EBBndrySten* sten,
-  const int Nsten,
-  const EBBndryGeom* ebg,
-  const int /*Nebg*/,
+  const EBBndryView& ebb,
   amrex::Array4<const amrex::Real> const& q,
   amrex::Array4<const amrex::Real> const& coeff,
   const amrex::Real* bcval,
@@ -572,17 +661,17 @@ pc_apply_eb_boundry_visc_flux_stencil(
 {
   const auto lo = amrex::lbound(bx);
   const auto hi = amrex::ubound(bx);
+  const int Nsten = ebb.ncut;
 
   amrex::ParallelFor(Nsten, [=] AMREX_GPU_DEVICE(int L) {
-    const auto& iv = sten[L].iv;
+    const amrex::IntVect iv = ebb.iv[L];
     if (is_inside(iv, lo, hi)) {
+      const amrex::Real ebn[AMREX_SPACEDIM] = {AMREX_D_DECL(
+        ebb.normal(L, 0), ebb.normal(L, 1), ebb.normal(L, 2))};
       const amrex::Real Nmag = std::sqrt(AMREX_D_TERM(
-        ebg[L].eb_normal[0] * ebg[L].eb_normal[0],
-        +ebg[L].eb_normal[1] * ebg[L].eb_normal[1],
-        +ebg[L].eb_normal[2] * ebg[L].eb_normal[2]));
-      const amrex::Real norm[AMREX_SPACEDIM] = {AMREX_D_DECL(
-        ebg[L].eb_normal[0] / Nmag, ebg[L].eb_normal[1] / Nmag,
-        ebg[L].eb_normal[2] / Nmag)};
+        ebn[0] * ebn[0], +ebn[1] * ebn[1], +ebn[2] * ebn[2]));
+      const amrex::Real norm[AMREX_SPACEDIM] = {
+        AMREX_D_DECL(ebn[0] / Nmag, ebn[1] / Nmag, ebn[2] / Nmag)};
 
 #if AMREX_SPACEDIM == 2
       const amrex::Real t1[AMREX_SPACEDIM] = {-norm[1], norm[0]};
@@ -616,41 +705,6 @@ pc_apply_eb_boundry_visc_flux_stencil(
                      , Qt[2][idir] = t2[idir];)
       }
 
-      // Transform velocities at stencil points to coordinates aligned with EB
-      amrex::Real Uo AMREX_D_TERM([3], [3], [3])[AMREX_SPACEDIM];
-      for (int ii = 0; ii < 3; ii++) {
-        for (int jj = 0; jj < 3; jj++) {
-#if AMREX_SPACEDIM > 2
-          for (int kk = 0; kk < 3; kk++) {
-#endif
-            for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
-              const amrex::IntVect ivp =
-                sten[L].iv_base + amrex::IntVect{AMREX_D_DECL(ii, jj, kk)};
-              Uo AMREX_D_TERM([ii], [jj], [kk])[idir] = q(ivp, QU + idir);
-            }
-#if AMREX_SPACEDIM > 2
-          }
-#endif
-        }
-      }
-      amrex::Real Ut AMREX_D_TERM([3], [3], [3])[AMREX_SPACEDIM];
-      for (int ii = 0; ii < 3; ii++) {
-        for (int jj = 0; jj < 3; jj++) {
-#if AMREX_SPACEDIM > 2
-          for (int kk = 0; kk < 3; kk++) {
-#endif
-            for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
-              Ut AMREX_D_TERM([ii], [jj], [kk])[idir] = AMREX_D_TERM(
-                Qt[idir][0] * Uo AMREX_D_TERM([ii], [jj], [kk])[0],
-                +Qt[idir][1] * Uo AMREX_D_TERM([ii], [jj], [kk])[1],
-                +Qt[idir][2] * Uo AMREX_D_TERM([ii], [jj], [kk])[2]);
-            }
-#if AMREX_SPACEDIM > 2
-          }
-#endif
-        }
-      }
-
       // Transform eb boundary velocities to coordinates aligned with EB
       amrex::Real bco[AMREX_SPACEDIM];
       for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
@@ -663,25 +717,25 @@ pc_apply_eb_boundry_visc_flux_stencil(
           Qt[idir][0] * bco[0], +Qt[idir][1] * bco[1], +Qt[idir][2] * bco[2]);
       }
 
-      // Compute normal derivative (times eb area) using precomputed stencil
+      // Compute normal derivative (times eb area) using precomputed stencil,
+      // with the velocities at the stencil points in coordinates aligned
+      // with the EB
       amrex::Real sum[AMREX_SPACEDIM] = {0.0};
-      for (int ii = 0; ii < 3; ii++) {
-        for (int jj = 0; jj < 3; jj++) {
-#if AMREX_SPACEDIM > 2
-          for (int kk = 0; kk < 3; kk++) {
-#endif
-            for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
-              sum[idir] += sten[L].val PELEC_D_TERM_REVERSE([kk], [jj], [ii]) *
-                           Ut AMREX_D_TERM([ii], [jj], [kk])[idir];
-            }
-#if AMREX_SPACEDIM > 2
-          }
-#endif
+      for (int m = ebb.start[L]; m < ebb.start[L + 1]; m++) {
+        const amrex::IntVect ivp = ebb.sten_iv(L, m);
+        amrex::Real Uo[AMREX_SPACEDIM];
+        for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
+          Uo[idir] = q(ivp, QU + idir);
+        }
+        for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
+          const amrex::Real Ut = AMREX_D_TERM(
+            Qt[idir][0] * Uo[0], +Qt[idir][1] * Uo[1], +Qt[idir][2] * Uo[2]);
+          sum[idir] += ebb.w[m] * Ut;
         }
       }
       amrex::Real dUtdn[AMREX_SPACEDIM];
       for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
-        dUtdn[idir] = sum[idir] + bct[idir] * sten[L].bcval_sten;
+        dUtdn[idir] = sum[idir] + bct[idir] * ebb.bcval_sten[L];
       }
 
       const amrex::Real tauDotN[AMREX_SPACEDIM] = {AMREX_D_DECL(
@@ -700,8 +754,7 @@ pc_apply_eb_boundry_visc_flux_stencil(
 void
 pc_apply_eb_boundry_flux_stencil(
   const amrex::Box& bx,
-  const EBBndrySten* sten,
-  const int Nsten,
+  const EBBndryView& ebb,
   amrex::Array4<const amrex::Real> const& s,
   const int scomp,
   amrex::Array4<const amrex::Real> const& D,
@@ -714,29 +767,18 @@ pc_apply_eb_boundry_flux_stencil(
 {
   const auto lo = amrex::lbound(bx);
   const auto hi = amrex::ubound(bx);
+  const int Nsten = ebb.ncut;
 
   amrex::ParallelFor(Nsten, [=] AMREX_GPU_DEVICE(int L) {
-    const amrex::IntVect iv = sten[L].iv;
+    const amrex::IntVect iv = ebb.iv[L];
     if (is_inside(iv, lo, hi)) {
       for (int n = 0; n < nc; n++) {
         amrex::Real sum = 0.0;
-        for (int ii = 0; ii < 3; ii++) {
-          for (int jj = 0; jj < 3; jj++) {
-#if AMREX_SPACEDIM > 2
-            for (int kk = 0; kk < 3; kk++) {
-#endif
-              const amrex::IntVect ivp = amrex::IntVect(AMREX_D_DECL(
-                sten[L].iv_base[0] + ii, sten[L].iv_base[1] + jj,
-                sten[L].iv_base[2] + kk));
-              sum += sten[L].val PELEC_D_TERM_REVERSE([kk], [jj], [ii]) *
-                     s(ivp, scomp + n);
-#if AMREX_SPACEDIM > 2
-            }
-#endif
-          }
+        for (int m = ebb.start[L]; m < ebb.start[L + 1]; m++) {
+          sum += ebb.w[m] * s(ebb.sten_iv(L, m), scomp + n);
         }
         bcflux[n * Nflux + L] =
-          D(iv, Dcomp + n) * (bcval[n * Nsten + L] * sten[L].bcval_sten + sum);
+          D(iv, Dcomp + n) * (bcval[n * Nsten + L] * ebb.bcval_sten[L] + sum);
       }
     }
   });
@@ -402,6 +402,17 @@ Filter::set_gaussian_5pt_optimized_approx_weights()
   _weights[4] = _weights[0];
 }
 
+// Keep the weights on the device for the lifetime of the filter
+void
+Filter::set_device_weights()
+{
+  _d_weights.resize(_weights.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, _weights.begin(), _weights.end(),
+    _d_weights.begin());
+  _scratch = std::make_shared<ScratchFabPool>();
+}
+
 // Run the filtering operation on a MultiFab
 void
 Filter::apply_filter(const amrex::MultiFab& in, amrex::MultiFab& out)
@@ -452,6 +463,8 @@ Filter::apply_filter(
   apply_filter(cbox, in, out, nstart, ncnt, ncomp);
 }
 
+// Filter components 0 to ncnt-nstart-1 of in into components nstart to
+// ncnt-1 of out with one 1D sweep per direction
 void
 Filter::apply_filter(
   const amrex::Box& box,
@@ -461,25 +474,85 @@ Filter::apply_filter(
   const int ncnt,
   const int /*ncomp*/)
 {
-  const auto q = in.array();
+  const int nc = ncnt - nstart;
+  const int g = _ngrow;
+  const amrex::Real* w = _d_weights.data();
+
+  // On the CPU the components are filtered a few at a time so that the
+  // scratch fabs of a tile stay small. On GPU a sweep covers all of them.
+  const int nblock = ScratchFabPool::active() ? amrex::min(nc, 4) : nc;
+
+  // Direction d is swept over the box grown in the directions still to be
+  // swept, into a scratch fab, and the last sweep writes to out
+  ScratchFab tmp[2];
+  for (int c0 = 0; c0 < nc; c0 += nblock) {
+    const int nb = amrex::min(nblock, nc - c0);
+    amrex::Array4<const amrex::Real> src = in.const_array();
+    int src_start = c0;
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      amrex::Box sbox = box;
+      for (int dd = d + 1; dd < AMREX_SPACEDIM; dd++) {
+        sbox.grow(dd, g);
+      }
+      amrex::Array4<amrex::Real> dst;
+      int dst_start = 0;
+      if (d == AMREX_SPACEDIM - 1) {
+        dst = out.array();
+        dst_start = nstart + c0;
+      } else {
+        if (c0 == 0) {
+          tmp[d % 2].define(*_scratch, sbox, nblock);
+        }
+        dst = tmp[d % 2].array();
+      }
+      const int di = d == 0 ? 1 : 0;
+      const int dj = d == 1 ? 1 : 0;
+      const int dk = d == 2 ? 1 : 0;
+      amrex::ParallelFor(
+        sbox, nb, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+          amrex::Real sum = 0.0;
+          for (int l = -g; l <= g; l++) {
+            sum += w[l + g] *
+                   src(i + l * di, j + l * dj, k + l * dk, n + src_start);
+          }
+          dst(i, j, k, n + dst_start) = sum;
+        });
+      src = dst;
+      src_start = 0;
+    }
+  }
+}
+
+void
+Filter::apply_filter_tensor(
+  const amrex::Box& box,
+  const amrex::FArrayBox& in,
+  amrex::FArrayBox& out,
+  const int nstart,
+  const int ncnt)
+{
+  BL_PROFILE("Filter::apply_filter_tensor()");
+  const auto q = in.const_array();
   auto qh = out.array();
   setC(box, nstart, ncnt, qh, 0.0);
-  amrex::Gpu::DeviceVector<amrex::Real> weights(_weights.size());
-  amrex::Real* w = weights.data();
-  amrex::Gpu::copy(
-    amrex::Gpu::hostToDevice, _weights.begin(), _weights.end(),
-    weights.begin());
+  const amrex::Real* w = _d_weights.data();
 
   const int captured_ngrow = _ngrow;
+  // Directions beyond AMREX_SPACEDIM are not filtered
+  const int gy = AMREX_SPACEDIM > 1 ? captured_ngrow : 0;
+  const int gz = AMREX_SPACEDIM > 2 ? captured_ngrow : 0;
   amrex::ParallelFor(
     box, ncnt - nstart,
     [=] AMREX_GPU_DEVICE(int i, int j, int k, int nc) noexcept {
-      for (int n = -captured_ngrow; n <= captured_ngrow; n++) {
-        for (int m = -captured_ngrow; m <= captured_ngrow; m++) {
+      for (int n = -gz; n <= gz; n++) {
+        const amrex::Real wz =
+          AMREX_SPACEDIM > 2 ? w[n + captured_ngrow] : 1.0;
+        for (int m = -gy; m <= gy; m++) {
+          const amrex::Real wy =
+            AMREX_SPACEDIM > 1 ? w[m + captured_ngrow] : 1.0;
           for (int l = -captured_ngrow; l <= captured_ngrow; l++) {
             qh(i, j, k, nc + nstart) +=
-              w[l + captured_ngrow] * w[m + captured_ngrow] *
-              w[n + captured_ngrow] * q(i + l, j + m, k + n, nc);
+              w[l + captured_ngrow] * wy * wz * q(i + l, j + m, k + n, nc);
           }
         }
       }
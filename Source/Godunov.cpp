@@ -30,7 +30,8 @@ pc_umeth_3D(
   const amrex::Real* del,
   const amrex::Real dt,
   const int ppm_type,
-  const int use_flattening)
+  const int use_flattening,
+  ScratchFabPool& pool)
 {
   amrex::Real const dx = del[0];
   amrex::Real const dy = del[1];
@@ -64,10 +65,8 @@ pc_umeth_3D(
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qxm(xmbx, QVAR);
-  amrex::FArrayBox qxp(bxg2, QVAR);
-  amrex::Elixir qxmeli = qxm.elixir();
-  amrex::Elixir qxpeli = qxp.elixir();
+  ScratchFab qxm(pool, xmbx, QVAR);
+  ScratchFab qxp(pool, bxg2, QVAR);
   auto const& qxmarr = qxm.array();
   auto const& qxparr = qxp.array();
 
@@ -75,10 +74,8 @@ pc_umeth_3D(
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qym(ymbx, QVAR);
-  amrex::FArrayBox qyp(bxg2, QVAR);
-  amrex::Elixir qymeli = qym.elixir();
-  amrex::Elixir qypeli = qyp.elixir();
+  ScratchFab qym(pool, ymbx, QVAR);
+  ScratchFab qyp(pool, bxg2, QVAR);
   auto const& qymarr = qym.array();
   auto const& qyparr = qyp.array();
 
@@ -86,10 +83,8 @@ pc_umeth_3D(
   cdir = 2;
   const amrex::Box& zmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& zflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qzm(zmbx, QVAR);
-  amrex::FArrayBox qzp(bxg2, QVAR);
-  amrex::Elixir qzmeli = qzm.elixir();
-  amrex::Elixir qzpeli = qzp.elixir();
+  ScratchFab qzm(pool, zmbx, QVAR);
+  ScratchFab qzp(pool, bxg2, QVAR);
   auto const& qzmarr = qzm.array();
   auto const& qzparr = qzp.array();
 
@@ -151,11 +146,9 @@ pc_umeth_3D(
   // These are the first flux estimates as per the corner-transport-upwind
   // method X initial fluxes
   cdir = 0;
-  amrex::FArrayBox fx(xflxbx, NVAR);
-  amrex::Elixir fxeli = fx.elixir();
+  ScratchFab fx(pool, xflxbx, NVAR);
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(xflxbx, NGDNV);
-  amrex::Elixir qgdxeli = qgdx.elixir();
+  ScratchFab qgdx(pool, xflxbx, NGDNV);
   auto const& gdtempx = qgdx.array();
   amrex::ParallelFor(
     xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -166,11 +159,9 @@ pc_umeth_3D(
 
   // Y initial fluxes
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR);
-  amrex::Elixir fyeli = fy.elixir();
+  ScratchFab fy(pool, yflxbx, NVAR);
   auto const& fyarr = fy.array();
-  amrex::FArrayBox qgdy(yflxbx, NGDNV);
-  amrex::Elixir qgdyeli = qgdy.elixir();
+  ScratchFab qgdy(pool, yflxbx, NGDNV);
   auto const& gdtempy = qgdy.array();
   amrex::ParallelFor(
     yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -181,11 +172,9 @@ pc_umeth_3D(
 
   // Z initial fluxes
   cdir = 2;
-  amrex::FArrayBox fz(zflxbx, NVAR);
-  amrex::Elixir fzeli = fz.elixir();
+  ScratchFab fz(pool, zflxbx, NVAR);
   auto const& fzarr = fz.array();
-  amrex::FArrayBox qgdz(zflxbx, NGDNV);
-  amrex::Elixir qgdzeli = qgdz.elixir();
+  ScratchFab qgdz(pool, zflxbx, NGDNV);
   auto const& gdtempz = qgdz.array();
   amrex::ParallelFor(
     zflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -198,17 +187,13 @@ pc_umeth_3D(
   cdir = 0;
   const amrex::Box& txbx = grow(bxg1, cdir, 1);
   const amrex::Box& txbxm = growHi(txbx, cdir, 1);
-  amrex::FArrayBox qxym(txbxm, QVAR);
-  amrex::Elixir qxymeli = qxym.elixir();
-  amrex::FArrayBox qxyp(txbx, QVAR);
-  amrex::Elixir qxypeli = qxyp.elixir();
+  ScratchFab qxym(pool, txbxm, QVAR);
+  ScratchFab qxyp(pool, txbx, QVAR);
   auto const& qmxy = qxym.array();
   auto const& qpxy = qxyp.array();
 
-  amrex::FArrayBox qxzm(txbxm, QVAR);
-  amrex::Elixir qxzmeli = qxzm.elixir();
-  amrex::FArrayBox qxzp(txbx, QVAR);
-  amrex::Elixir qxzpeli = qxzp.elixir();
+  ScratchFab qxzm(pool, txbxm, QVAR);
+  ScratchFab qxzp(pool, txbx, QVAR);
   auto const& qmxz = qxzm.array();
   auto const& qpxz = qxzp.array();
 
@@ -222,14 +207,10 @@ pc_umeth_3D(
   });
 
   const amrex::Box& txfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxxy(txfxbx, NVAR);
-  amrex::FArrayBox fluxxz(txfxbx, NVAR);
-  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV);
-  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV);
-  amrex::Elixir fluxxyeli = fluxxy.elixir();
-  amrex::Elixir gdvxyeli = gdvxyfab.elixir();
-  amrex::Elixir fluxxzeli = fluxxz.elixir();
-  amrex::Elixir gdvxzeli = gdvxzfab.elixir();
+  ScratchFab fluxxy(pool, txfxbx, NVAR);
+  ScratchFab fluxxz(pool, txfxbx, NVAR);
+  ScratchFab gdvxyfab(pool, txfxbx, NGDNV);
+  ScratchFab gdvxzfab(pool, txfxbx, NGDNV);
 
   auto const& flxy = fluxxy.array();
   auto const& flxz = fluxxz.array();
@@ -249,23 +230,19 @@ pc_umeth_3D(
         *lpmap);
     });
 
-  qxymeli.clear();
-  qxypeli.clear();
-  qxzmeli.clear();
-  qxzpeli.clear();
+  qxym.clear();
+  qxyp.clear();
+  qxzm.clear();
+  qxzp.clear();
 
   // Y interface corrections
   cdir = 1;
   const amrex::Box& tybx = grow(bxg1, cdir, 1);
   const amrex::Box& tybxm = growHi(tybx, cdir, 1);
-  amrex::FArrayBox qyxm(tybxm, QVAR);
-  amrex::FArrayBox qyxp(tybx, QVAR);
-  amrex::FArrayBox qyzm(tybxm, QVAR);
-  amrex::FArrayBox qyzp(tybx, QVAR);
-  amrex::Elixir qyxmeli = qyxm.elixir();
-  amrex::Elixir qyxpeli = qyxp.elixir();
-  amrex::Elixir qyzmeli = qyzm.elixir();
-  amrex::Elixir qyzpeli = qyzp.elixir();
+  ScratchFab qyxm(pool, tybxm, QVAR);
+  ScratchFab qyxp(pool, tybx, QVAR);
+  ScratchFab qyzm(pool, tybxm, QVAR);
+  ScratchFab qyzp(pool, tybx, QVAR);
   auto const& qmyx = qyxm.array();
   auto const& qpyx = qyxp.array();
   auto const& qmyz = qyzm.array();
@@ -280,19 +257,15 @@ pc_umeth_3D(
       i, j, k, qmyz, qpyz, qymarr, qyparr, fzarr, qaux, gdtempz, cdtdz, *lpmap);
   });
 
-  fzeli.clear();
-  qgdzeli.clear();
+  fz.clear();
+  qgdz.clear();
 
   // Riemann problem Y|X Y|Z
   const amrex::Box& tyfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxyx(tyfxbx, NVAR);
-  amrex::FArrayBox fluxyz(tyfxbx, NVAR);
-  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV);
-  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV);
-  amrex::Elixir fluxyxeli = fluxyx.elixir();
-  amrex::Elixir gdvyxeli = gdvyxfab.elixir();
-  amrex::Elixir fluxyzeli = fluxyz.elixir();
-  amrex::Elixir gdvyzeli = gdvyzfab.elixir();
+  ScratchFab fluxyx(pool, tyfxbx, NVAR);
+  ScratchFab fluxyz(pool, tyfxbx, NVAR);
+  ScratchFab gdvyxfab(pool, tyfxbx, NGDNV);
+  ScratchFab gdvyzfab(pool, tyfxbx, NGDNV);
 
   auto const& flyx = fluxyx.array();
   auto const& flyz = fluxyz.array();
@@ -311,23 +284,19 @@ pc_umeth_3D(
         *lpmap);
     });
 
-  qyxmeli.clear();
-  qyxpeli.clear();
-  qyzmeli.clear();
-  qyzpeli.clear();
+  qyxm.clear();
+  qyxp.clear();
+  qyzm.clear();
+  qyzp.clear();
 
   // Z interface corrections
   cdir = 2;
   const amrex::Box& tzbx = grow(bxg1, cdir, 1);
   const amrex::Box& tzbxm = growHi(tzbx, cdir, 1);
-  amrex::FArrayBox qzxm(tzbxm, QVAR);
-  amrex::FArrayBox qzxp(tzbx, QVAR);
-  amrex::FArrayBox qzym(tzbxm, QVAR);
-  amrex::FArrayBox qzyp(tzbx, QVAR);
-  amrex::Elixir qzxmeli = qzxm.elixir();
-  amrex::Elixir qzxpeli = qzxp.elixir();
-  amrex::Elixir qzymeli = qzym.elixir();
-  amrex::Elixir qzypeli = qzyp.elixir();
+  ScratchFab qzxm(pool, tzbxm, QVAR);
+  ScratchFab qzxp(pool, tzbx, QVAR);
+  ScratchFab qzym(pool, tzbxm, QVAR);
+  ScratchFab qzyp(pool, tzbx, QVAR);
 
   auto const& qmzx = qzxm.array();
   auto const& qpzx = qzxp.array();
@@ -343,21 +312,17 @@ pc_umeth_3D(
       i, j, k, qmzy, qpzy, qzmarr, qzparr, fyarr, qaux, gdtempy, cdtdy, *lpmap);
   });
 
-  fxeli.clear();
-  fyeli.clear();
-  qgdxeli.clear();
-  qgdyeli.clear();
+  fx.clear();
+  fy.clear();
+  qgdx.clear();
+  qgdy.clear();
 
   // Riemann problem Z|X Z|Y
   const amrex::Box& tzfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxzx(tzfxbx, NVAR);
-  amrex::FArrayBox fluxzy(tzfxbx, NVAR);
-  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV);
-  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV);
-  amrex::Elixir fluxzxeli = fluxzx.elixir();
-  amrex::Elixir gdvzxeli = gdvzxfab.elixir();
-  amrex::Elixir fluxzyeli = fluxzy.elixir();
-  amrex::Elixir gdvzyeli = gdvzyfab.elixir();
+  ScratchFab fluxzx(pool, tzfxbx, NVAR);
+  ScratchFab fluxzy(pool, tzfxbx, NVAR);
+  ScratchFab gdvzxfab(pool, tzfxbx, NGDNV);
+  ScratchFab gdvzyfab(pool, tzfxbx, NGDNV);
 
   auto const& flzx = fluxzx.array();
   auto const& flzy = fluxzy.array();
@@ -376,16 +341,14 @@ pc_umeth_3D(
         *lpmap);
     });
 
-  qzxmeli.clear();
-  qzxpeli.clear();
-  qzymeli.clear();
-  qzypeli.clear();
+  qzxm.clear();
+  qzxp.clear();
+  qzym.clear();
+  qzyp.clear();
 
   // Temp Fabs for Final Fluxes
-  amrex::FArrayBox qmfab(bxg2, QVAR);
-  amrex::FArrayBox qpfab(bxg1, QVAR);
-  amrex::Elixir qmeli = qmfab.elixir();
-  amrex::Elixir qpeli = qpfab.elixir();
+  ScratchFab qmfab(pool, bxg2, QVAR);
+  ScratchFab qpfab(pool, bxg1, QVAR);
   auto const& qm = qmfab.array();
   auto const& qp = qpfab.array();
 
@@ -399,12 +362,12 @@ pc_umeth_3D(
       hdtdy, hdtdz, *lpmap);
   });
 
-  fluxzyeli.clear();
-  gdvzyeli.clear();
-  gdvyzeli.clear();
-  fluxyzeli.clear();
-  qxmeli.clear();
-  qxpeli.clear();
+  fluxzy.clear();
+  gdvzyfab.clear();
+  gdvyzfab.clear();
+  fluxyz.clear();
+  qxm.clear();
+  qxp.clear();
   // Final X flux
   amrex::ParallelFor(xfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
     pc_cmpflx(
@@ -421,12 +384,12 @@ pc_umeth_3D(
       hdtdx, hdtdz, *lpmap);
   });
 
-  fluxzxeli.clear();
-  gdvzxeli.clear();
-  gdvxzeli.clear();
-  fluxxzeli.clear();
-  qymeli.clear();
-  qypeli.clear();
+  fluxzx.clear();
+  gdvzxfab.clear();
+  gdvxzfab.clear();
+  fluxxz.clear();
+  qym.clear();
+  qyp.clear();
   // Final Y flux
   amrex::ParallelFor(yfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
     pc_cmpflx(
@@ -443,20 +406,20 @@ pc_umeth_3D(
       hdtdx, hdtdy, *lpmap);
   });
 
-  gdvyxeli.clear();
-  fluxyxeli.clear();
-  gdvxyeli.clear();
-  fluxxyeli.clear();
-  qzmeli.clear();
-  qzpeli.clear();
+  gdvyxfab.clear();
+  fluxyx.clear();
+  gdvxyfab.clear();
+  fluxxy.clear();
+  qzm.clear();
+  qzp.clear();
   // Final Z flux
   amrex::ParallelFor(zfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
     pc_cmpflx(
       i, j, k, bclz, bchz, dlz, dhz, qm, qp, flx3, q3, qaux, cdir, *lpmap);
   });
 
-  qmeli.clear();
-  qpeli.clear();
+  qm.clear();
+  qp.clear();
   // Construct p div{U}
   amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
     pc_pdivu(
@@ -489,7 +452,8 @@ pc_umeth_2D(
   const amrex::Real* del,
   const amrex::Real dt,
   const int ppm_type,
-  const int use_flattening)
+  const int use_flattening,
+  ScratchFabPool& pool)
 {
   amrex::Real const dx = del[0];
   amrex::Real const dy = del[1];
@@ -513,10 +477,8 @@ pc_umeth_2D(
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qxm(xmbx, QVAR);
-  amrex::FArrayBox qxp(bxg2, QVAR);
-  amrex::Elixir qxmeli = qxm.elixir();
-  amrex::Elixir qxpeli = qxp.elixir();
+  ScratchFab qxm(pool, xmbx, QVAR);
+  ScratchFab qxp(pool, bxg2, QVAR);
   auto const& qxmarr = qxm.array();
   auto const& qxparr = qxp.array();
 
@@ -524,10 +486,8 @@ pc_umeth_2D(
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qym(ymbx, QVAR);
-  amrex::FArrayBox qyp(bxg2, QVAR);
-  amrex::Elixir qymeli = qym.elixir();
-  amrex::Elixir qypeli = qyp.elixir();
+  ScratchFab qym(pool, ymbx, QVAR);
+  ScratchFab qyp(pool, bxg2, QVAR);
   auto const& qymarr = qym.array();
   auto const& qyparr = qyp.array();
 
@@ -570,11 +530,9 @@ pc_umeth_2D(
   // These are the first flux estimates as per the corner-transport-upwind
   // method X initial fluxes
   cdir = 0;
-  amrex::FArrayBox fx(xflxbx, NVAR);
-  amrex::Elixir fxeli = fx.elixir();
+  ScratchFab fx(pool, xflxbx, NVAR);
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(bxg2, NGDNV);
-  amrex::Elixir qgdxeli = qgdx.elixir();
+  ScratchFab qgdx(pool, bxg2, NGDNV);
   auto const& gdtemp = qgdx.array();
   amrex::ParallelFor(
     xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -585,8 +543,7 @@ pc_umeth_2D(
 
   // Y initial fluxes
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR);
-  amrex::Elixir fyeli = fy.elixir();
+  ScratchFab fy(pool, yflxbx, NVAR);
   auto const& fyarr = fy.array();
   amrex::ParallelFor(
     yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -598,10 +555,8 @@ pc_umeth_2D(
   // X interface corrections
   cdir = 0;
   const amrex::Box& tybx = grow(bx, cdir, 1);
-  amrex::FArrayBox qm(bxg2, QVAR);
-  amrex::Elixir qmeli = qm.elixir();
-  amrex::FArrayBox qp(bxg1, QVAR);
-  amrex::Elixir qpeli = qp.elixir();
+  ScratchFab qm(pool, bxg2, QVAR);
+  ScratchFab qp(pool, bxg1, QVAR);
   auto const& qmarr = qm.array();
   auto const& qparr = qp.array();
 
@@ -611,9 +566,9 @@ pc_umeth_2D(
       *lpmap);
   });
 
-  fyeli.clear();
-  qxmeli.clear();
-  qxpeli.clear();
+  fy.clear();
+  qxm.clear();
+  qxp.clear();
   const amrex::Box& xfxbx = surroundingNodes(bx, cdir);
 
   // Final Riemann problem X
@@ -632,9 +587,9 @@ pc_umeth_2D(
       i, j, k, qmarr, qparr, qymarr, qyparr, fxarr, srcQ, qaux, gdtemp, a1, vol,
       hdt, *lpmap);
   });
-  fxeli.clear();
-  qymeli.clear();
-  qypeli.clear();
+  fx.clear();
+  qym.clear();
+  qyp.clear();
 
   // Final Riemann problem Y
   const amrex::Box& yfxbx = surroundingNodes(bx, cdir);
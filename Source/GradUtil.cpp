@@ -7,7 +7,7 @@ pc_compute_tangential_vel_derivs_eb(
   const int dir,
   const amrex::Real dx1,
   const amrex::Real dx2,
-  const EBBndryGeom* sv_ebg,
+  const EBBndryView& sv_ebg,
   const int Ncut,
   const amrex::Array4<const amrex::Real>& q,
   const amrex::Array4<amrex::EBCellFlag const>& flags,
@@ -26,8 +26,8 @@ pc_compute_tangential_vel_derivs_eb(
       int i = 0;
       int j = 0;
       int k = 0;
-      AMREX_D_TERM(i = sv_ebg[L].iv[0];, j = sv_ebg[L].iv[1];
-                   , k = sv_ebg[L].iv[2];);
+      AMREX_D_TERM(i = sv_ebg.iv[L][0];, j = sv_ebg.iv[L][1];
+                   , k = sv_ebg.iv[L][2];);
       const amrex::IntVect iv = amrex::IntVect{AMREX_D_DECL(i, j, k)};
       if (is_inside(iv, lo, hi)) {
         const int jhip = j + flags(i, j, k).isConnected(0, 1, 0);
@@ -76,8 +76,8 @@ pc_compute_tangential_vel_derivs_eb(
       int i = 0;
       int j = 0;
       int k = 0;
-      AMREX_D_TERM(i = sv_ebg[L].iv[0];, j = sv_ebg[L].iv[1];
-                   , k = sv_ebg[L].iv[2];);
+      AMREX_D_TERM(i = sv_ebg.iv[L][0];, j = sv_ebg.iv[L][1];
+                   , k = sv_ebg.iv[L][2];);
       const amrex::IntVect iv = amrex::IntVect{AMREX_D_DECL(i, j, k)};
       if (is_inside(iv, lo, hi)) {
         const int ihip = i + flags(i, j, k).isConnected(1, 0, 0);
@@ -123,9 +123,9 @@ pc_compute_tangential_vel_derivs_eb(
     });
   } else if (dir == 2) {
     amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const int i = sv_ebg[L].iv[0];
-      const int j = sv_ebg[L].iv[1];
-      const int k = sv_ebg[L].iv[2];
+      const int i = sv_ebg.iv[L][0];
+      const int j = sv_ebg.iv[L][1];
+      const int k = sv_ebg.iv[L][2];
       const amrex::IntVect iv = amrex::IntVect{AMREX_D_DECL(i, j, k)};
       if (is_inside(iv, lo, hi)) {
         const int ihip = i + flags(i, j, k).isConnected(1, 0, 0);
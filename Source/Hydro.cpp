@@ -22,7 +22,7 @@ PeleC::construct_hydro_source(
       amrex::Print() << "... Computing hydro advance" << std::endl;
     }
 
-    AMREX_ASSERT(S.nGrow() == numGrow() + nGrowF);
+    AMREX_ASSERT(S.nGrow() >= numGrow() + nGrowF);
     sources_for_hydro.setVal(0.0);
     int ng = 0; // TODO: This is currently the largest ngrow of the source
                 // data...maybe this needs fixing?
@@ -107,31 +107,27 @@ PeleC::construct_hydro_source(
       for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
            ++mfi) {
 
+        const amrex::Real wt = amrex::ParallelDescriptor::second();
+
         const amrex::Box& bx = mfi.tilebox();
         const amrex::Box& qbx = amrex::grow(bx, numGrow() + nGrowF);
         const amrex::Box& fbx = amrex::grow(bx, nGrowF);
         // const int* lo = bx.loVect();
         // const int* hi = bx.hiVect();
 
-        amrex::GpuArray<amrex::FArrayBox, AMREX_SPACEDIM> flux;
-        amrex::Elixir flux_eli[AMREX_SPACEDIM];
+        ScratchFab flux[AMREX_SPACEDIM];
         for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
           const amrex::Box& efbx = surroundingNodes(fbx, dir);
-          flux[dir].resize(efbx, NVAR);
-          flux_eli[dir] = flux[dir].elixir();
+          flux[dir].define(scratch_pool, efbx, NVAR);
         }
 
         auto const& s = S.array(mfi);
         auto const& hyd_src = hydro_source.array(mfi);
 
-        // Resize Temporary Fabs
-        amrex::FArrayBox q(qbx, QVAR);
-        amrex::FArrayBox qaux(qbx, NQAUX);
-        amrex::FArrayBox src_q(qbx, QVAR);
-        // Use Elixir Construct to steal the Fabs metadata
-        amrex::Elixir qeli = q.elixir();
-        amrex::Elixir qauxeli = qaux.elixir();
-        amrex::Elixir src_qeli = src_q.elixir();
+        // Temporary Fabs borrowed from the level scratch pool
+        ScratchFab q(scratch_pool, qbx, QVAR);
+        ScratchFab qaux(scratch_pool, qbx, NQAUX);
+        ScratchFab src_q(scratch_pool, qbx, QVAR);
         // Get Arrays to pass to the gpu.
         auto const& qarr = q.array();
         auto const& qauxar = qaux.array();
@@ -219,7 +215,8 @@ PeleC::construct_hydro_source(
         pc_umdrv(
           is_finest_level, time, fbx, domain_lo, domain_hi, phys_bc.lo(),
           phys_bc.hi(), s, hyd_src, qarr, qauxar, srcqarr, dx, dt, ppm_type,
-          use_flattening, flx_arr, a, volume.array(mfi), cflLoc);
+          use_flattening, flx_arr, a, volume.array(mfi), cflLoc,
+          scratch_pool);
         BL_PROFILE_VAR_STOP(purm);
 
         BL_PROFILE_VAR("courno + flux reg", crno);
@@ -229,8 +226,7 @@ PeleC::construct_hydro_source(
         if (use_explicit_filter) {
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
             const amrex::Box& bxtmp = amrex::surroundingNodes(bx, dir);
-            amrex::FArrayBox filtered_flux(bxtmp, NVAR);
-            amrex::Elixir filtered_flux_eli = filtered_flux.elixir();
+            ScratchFab filtered_flux(scratch_pool, bxtmp, NVAR);
             les_filter.apply_filter(
               bxtmp, flux[dir], filtered_flux, Density, NVAR);
 
@@ -239,8 +235,7 @@ PeleC::construct_hydro_source(
               bxtmp, flux[dir].nComp(), filtered_flux.array(), flx_arr[dir]);
           }
 
-          amrex::FArrayBox filtered_source_out(bx, NVAR);
-          amrex::Elixir filtered_source_out_eli = filtered_source_out.elixir();
+          ScratchFab filtered_source_out(scratch_pool, bx, NVAR);
           les_filter.apply_filter(
             bx, hydro_source[mfi], filtered_source_out, Density, NVAR);
 
@@ -273,6 +268,10 @@ PeleC::construct_hydro_source(
           }
         }
         BL_PROFILE_VAR_STOP(crno);
+
+        if (do_mol_load_balance) {
+          add_work_estimate(mfi, bx, wt);
+        }
       }
     }
 
@@ -358,25 +357,22 @@ pc_umdrv(
   const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
     a,
   amrex::Array4<amrex::Real> const& vol,
-  amrex::Real /*cflLoc*/)
+  amrex::Real /*cflLoc*/,
+  ScratchFabPool& pool)
 {
   // Set Up for Hydro Flux Calculations
   auto const& bxg2 = grow(bx, 2);
-  amrex::FArrayBox qec[AMREX_SPACEDIM];
-  amrex::Elixir qec_eli[AMREX_SPACEDIM];
+  ScratchFab qec[AMREX_SPACEDIM];
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
     const amrex::Box eboxes = amrex::surroundingNodes(bxg2, dir);
-    qec[dir].resize(eboxes, NGDNV);
-    qec_eli[dir] = qec[dir].elixir();
+    qec[dir].define(pool, eboxes, NGDNV);
   }
   amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> qec_arr{
     {AMREX_D_DECL(qec[0].array(), qec[1].array(), qec[2].array())}};
 
   // Temporary FArrayBoxes
-  amrex::FArrayBox divu(bxg2, 1);
-  amrex::FArrayBox pdivu(bx, 1);
-  amrex::Elixir divueli = divu.elixir();
-  amrex::Elixir pdiveli = pdivu.elixir();
+  ScratchFab divu(pool, bxg2, 1);
+  ScratchFab pdivu(pool, bx, 1);
   auto const& divarr = divu.array();
   auto const& pdivuarr = pdivu.array();
 
@@ -390,17 +386,14 @@ pc_umdrv(
   pc_umeth_2D(
     bx, bclo, bchi, domlo, domhi, q, qaux, src_q, // bcMask,
     flx[0], flx[1], qec_arr[0], qec_arr[1], a[0], a[1], pdivuarr, vol, dx, dt,
-    ppm_type, use_flattening);
+    ppm_type, use_flattening, pool);
 #elif AMREX_SPACEDIM == 3
   pc_umeth_3D(
     bx, bclo, bchi, domlo, domhi, q, qaux, src_q, // bcMask,
     flx[0], flx[1], flx[2], qec_arr[0], qec_arr[1], qec_arr[2], a[0], a[1],
-    a[2], pdivuarr, vol, dx, dt, ppm_type, use_flattening);
+    a[2], pdivuarr, vol, dx, dt, ppm_type, use_flattening, pool);
 #endif
   BL_PROFILE_VAR_STOP(umeth);
-  for (auto& dir : qec_eli) {
-    dir.clear();
-  }
 
   // divu
   AMREX_D_TERM(const amrex::Real dx0 = dx[0];, const amrex::Real dx1 = dx[1];
@@ -1,5 +1,9 @@
+#include <deque>
+#include <utility>
 #include <iomanip>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <memory>
 #include <string>
 #include <ctime>
@@ -8,6 +12,7 @@
 #include <omp.h>
 #endif
 
+#include <AMReX_AsyncOut.H>
 #include <AMReX_Utility.H>
 #include <AMReX_buildInfo.H>
 #include <AMReX_ParmParse.H>
@@ -19,6 +24,8 @@
 
 #include "PeleC.H"
 #include "IO.H"
+#include "PlotCompress.H"
+#include "Derive.H"
 #include "IndexDefines.H"
 
 // PeleC maintains an internal checkpoint version numbering system.
@@ -29,10 +36,13 @@
 // in updating version numbers:
 // 0: all checkpoints as of 11/21/16
 // 1: add body state
+// 2: add Chem_Dt_Type
 
 namespace {
 int input_version = -1;
-int current_version = 1;
+int current_version = 2;
+// Number of state types stored for the level being restarted
+int input_num_state = 0;
 std::string body_state_filename = "body_state.fab";
 amrex::Real vfraceps = 0.000001;
 } // namespace
@@ -66,6 +76,23 @@ PeleC::restart(amrex::Amr& papa, std::istream& is, bool bReadSpecial)
 
   AMREX_ASSERT(input_version >= 0);
 
+  // Peek at the level header for the number of state types it holds, so
+  // set_state_in_checkpoint can tell which of ours are missing
+  {
+    const auto pos = is.tellg();
+    int lev = 0;
+    amrex::Geometry g;
+    amrex::BoxArray ba;
+    is >> lev >> g;
+    if (bReadSpecial) {
+      amrex::readBoxArray(ba, is, bReadSpecial);
+    } else {
+      ba.readFrom(is);
+    }
+    is >> input_num_state;
+    is.seekg(pos);
+  }
+
   // Also need to mod checkPoint function to store the new version in a text
   // file
   AmrLevel::restart(papa, is, bReadSpecial);
@@ -80,6 +107,13 @@ PeleC::restart(amrex::Amr& papa, std::istream& is, bool bReadSpecial)
       state[i].define(
         geom.Domain(), grids, dmap, desc_lst[i], ctime, parent->dtLevel(level),
         *m_factory);
+#ifdef PELEC_USE_REACTIONS
+      if (i == Chem_Dt_Type) {
+        // No warm-start information in older checkpoints
+        get_new_data(Chem_Dt_Type).setVal(0.0);
+        continue;
+      }
+#endif
       state[i] = state[i - 1];
     }
   }
@@ -223,12 +257,20 @@ PeleC::restart(amrex::Amr& papa, std::istream& is, bool bReadSpecial)
 void
 PeleC::set_state_in_checkpoint(amrex::Vector<int>& state_in_checkpoint)
 {
+  // The state types stored are read in order into the ones marked present
+  int num_missing = num_state_type - input_num_state;
   for (int i = 0; i < num_state_type; ++i) {
     state_in_checkpoint[i] = 1;
-
-    if (i == Work_Estimate_Type) {
-      state_in_checkpoint[i] = 0;
-    }
+  }
+#ifdef PELEC_USE_REACTIONS
+  if (input_version < 2) {
+    state_in_checkpoint[Chem_Dt_Type] = 0;
+    num_missing--;
+  }
+#endif
+  // Only written by runs balancing on work estimates
+  if (num_missing > 0 && Work_Estimate_Type < num_state_type) {
+    state_in_checkpoint[Work_Estimate_Type] = 0;
   }
 }
 
@@ -337,6 +379,255 @@ PeleC::checkPoint(
 #endif
 }
 
+namespace {
+// Name of the checkpoint of step nstep, as Amr::checkPoint builds it
+std::string
+check_file_name(const std::string& suffix, const int nstep)
+{
+  amrex::ParmParse pp("amr");
+  std::string root = "chk";
+  pp.query("check_file", root);
+  int digits = 5;
+  pp.query("file_name_digits", digits);
+  return amrex::Concatenate(root + suffix, nstep, digits);
+}
+
+std::string
+level_dir(const std::string& dir, const int lev)
+{
+  return dir + "/Level_" + std::to_string(lev);
+}
+
+// Last component of a path, without trailing slashes
+std::string
+path_base_name(std::string path)
+{
+  while (path.size() > 1 && path.back() == '/') {
+    path.pop_back();
+  }
+  return path.substr(path.find_last_of('/') + 1);
+}
+} // namespace
+
+void
+PeleC::incrementalCheckPoint()
+{
+  BL_PROFILE("PeleC::incrementalCheckPoint()");
+
+#ifdef AMREX_PARTICLES
+  if (do_spray_particles) {
+    amrex::Abort("Incremental checkpoints do not support spray particles");
+  }
+#endif
+
+  amrex::Amr& amr = *parent;
+  const int finest_level = amr.finestLevel();
+  const int nstep = amr.levelSteps(0);
+
+  // A full checkpoint is needed every incr_check_full ones and after the
+  // grids changed
+  bool full = ckpt_base_name.empty() || ckpt_num_delta + 1 >= incr_check_full ||
+              static_cast<int>(ckpt_base.size()) != finest_level + 1;
+  for (int lev = 0; lev <= finest_level && !full; lev++) {
+    full = ckpt_base[lev]->boxArray() != getLevel(lev).boxArray();
+  }
+
+  if (full) {
+    amr.checkPoint();
+    ckpt_base_name = check_file_name("", nstep);
+    ckpt_num_delta = 0;
+    ckpt_base.resize(finest_level + 1);
+    for (int lev = 0; lev <= finest_level; lev++) {
+      const amrex::MultiFab& S = getLevel(lev).get_new_data(State_Type);
+      ckpt_base[lev] = std::make_unique<amrex::MultiFab>(
+        S.boxArray(), S.DistributionMap(), NVAR, 0);
+      amrex::MultiFab::Copy(*ckpt_base[lev], S, 0, 0, NVAR, 0);
+    }
+    return;
+  }
+
+  ckpt_num_delta++;
+  const std::string dir = check_file_name("_delta", nstep);
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    for (int lev = 0; lev <= finest_level; lev++) {
+      if (!amrex::UtilCreateDirectory(level_dir(dir, lev), 0755)) {
+        amrex::CreateDirectoryFailed(level_dir(dir, lev));
+      }
+    }
+  }
+  amrex::ParallelDescriptor::Barrier();
+
+  const amrex::Real tol = incr_check_tol;
+  amrex::Vector<int> num_dirty(finest_level + 1, 0);
+  amrex::Long total_boxes = 0;
+  for (int lev = 0; lev <= finest_level; lev++) {
+    const amrex::MultiFab& S = getLevel(lev).get_new_data(State_Type);
+    const amrex::BoxArray& ba = S.boxArray();
+    const amrex::DistributionMapping& dm = S.DistributionMap();
+    total_boxes += ba.size();
+
+    // The level may have been remapped since the full checkpoint
+    const amrex::MultiFab* base = ckpt_base[lev].get();
+    amrex::MultiFab base_remapped;
+    if (base->DistributionMap() != dm) {
+      base_remapped.define(ba, dm, NVAR, 0);
+      base_remapped.ParallelCopy(*base);
+      base = &base_remapped;
+    }
+
+    // Boxes with a value changed by more than tol times the largest
+    // magnitude of that component on the level in the base checkpoint
+    amrex::GpuArray<amrex::Real, NVAR> scale;
+    for (int n = 0; n < NVAR; n++) {
+      scale[n] = tol * base->norm0(n);
+    }
+    amrex::Vector<int> dirty(ba.size(), 0);
+    for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+      const amrex::Box& bx = mfi.validbox();
+      auto const& s = S.const_array(mfi);
+      auto const& b = base->const_array(mfi);
+      amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+      amrex::ReduceData<amrex::Real> reduce_data(reduce_op);
+      using ReduceTuple = typename decltype(reduce_data)::Type;
+      reduce_op.eval(
+        bx, NVAR, reduce_data,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept
+        -> ReduceTuple {
+          return {
+            amrex::Math::abs(s(i, j, k, n) - b(i, j, k, n)) - scale[n]};
+        });
+      ReduceTuple hv = reduce_data.value();
+      dirty[mfi.index()] = amrex::get<0>(hv) > 0.0 ? 1 : 0;
+    }
+    amrex::ParallelDescriptor::ReduceIntMax(dirty.dataPtr(), ba.size());
+
+    amrex::BoxList bl;
+    amrex::Vector<int> owners;
+    amrex::Vector<int> src_index;
+    for (int i = 0; i < ba.size(); i++) {
+      if (dirty[i] != 0) {
+        bl.push_back(ba[i]);
+        owners.push_back(dm[i]);
+        src_index.push_back(i);
+      }
+    }
+    num_dirty[lev] = src_index.size();
+    if (num_dirty[lev] == 0) {
+      continue;
+    }
+
+    // The changed boxes keep their owners, so this is a local copy
+    const amrex::BoxArray dba(bl);
+    const amrex::DistributionMapping ddm(owners);
+    amrex::MultiFab delta(dba, ddm, NVAR, 0);
+    for (amrex::MFIter mfi(delta); mfi.isValid(); ++mfi) {
+      delta[mfi].copy<amrex::RunOn::Device>(
+        S[src_index[mfi.index()]], mfi.validbox());
+    }
+    amrex::VisMF::Write(delta, level_dir(dir, lev) + "/SD_Delta");
+  }
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    std::ofstream header(dir + "/DeltaHeader");
+    if (!header.good()) {
+      amrex::FileOpenFailed(dir + "/DeltaHeader");
+    }
+    header << std::setprecision(17);
+    header << "PeleC incremental checkpoint 1\n";
+    header << ckpt_base_name << '\n';
+    header << ckpt_num_delta << '\n';
+    header << finest_level << '\n';
+    header << amr.cumTime() << '\n';
+    for (int lev = 0; lev <= finest_level; lev++) {
+      header << amr.levelSteps(lev) << ' ' << amr.levelCount(lev) << ' '
+             << amr.dtLevel(lev) << ' ' << num_dirty[lev] << '\n';
+    }
+  }
+
+  if (verbose > 0) {
+    amrex::Long total_dirty = 0;
+    for (const int n : num_dirty) {
+      total_dirty += n;
+    }
+    amrex::Print() << "Incremental checkpoint " << dir << ": " << total_dirty
+                   << " of " << total_boxes << " boxes changed since "
+                   << ckpt_base_name << std::endl;
+  }
+}
+
+void
+PeleC::restartFromDelta()
+{
+  BL_PROFILE("PeleC::restartFromDelta()");
+
+  amrex::Vector<char> file_chars;
+  amrex::ParallelDescriptor::ReadAndBcastFile(
+    restart_delta + "/DeltaHeader", file_chars);
+  std::istringstream header(std::string(file_chars.dataPtr()));
+
+  std::string line;
+  std::getline(header, line);
+  if (line != "PeleC incremental checkpoint 1") {
+    amrex::Abort(restart_delta + " is not an incremental checkpoint");
+  }
+  std::string base_name;
+  int num_delta = 0;
+  int finest_level = 0;
+  amrex::Real cumtime = 0.0;
+  header >> base_name >> num_delta >> finest_level >> cumtime;
+  if (path_base_name(base_name) != path_base_name(parent->theRestartFile())) {
+    amrex::Abort(
+      restart_delta + " was taken from " + base_name +
+      ", which amr.restart must name");
+  }
+  if (finest_level != parent->finestLevel()) {
+    amrex::Abort(restart_delta + " does not match the levels of " + base_name);
+  }
+  int level_steps = 0;
+  int level_count = 0;
+  amrex::Real dt = 0.0;
+  int num_dirty = 0;
+  for (int lev = 0; lev <= level; lev++) {
+    header >> level_steps >> level_count >> dt >> num_dirty;
+  }
+
+  // The restarted state is the base of the next incremental checkpoints
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+  if (level == 0) {
+    ckpt_base.clear();
+    ckpt_base.resize(finest_level + 1);
+    ckpt_base_name = base_name;
+    ckpt_num_delta = num_delta;
+  }
+  ckpt_base[level] = std::make_unique<amrex::MultiFab>(
+    S_new.boxArray(), S_new.DistributionMap(), NVAR, 0);
+  amrex::MultiFab::Copy(*ckpt_base[level], S_new, 0, 0, NVAR, 0);
+
+  if (num_dirty > 0) {
+    amrex::MultiFab delta;
+    amrex::VisMF::Read(delta, level_dir(restart_delta, level) + "/SD_Delta");
+    S_new.ParallelCopy(delta);
+  }
+
+  for (int typ = 0; typ < desc_lst.size(); typ++) {
+    state[typ].setTimeLevel(cumtime, dt, dt);
+  }
+  parent->setLevelSteps(level, level_steps);
+  parent->setLevelCount(level, level_count);
+  parent->setDtLevel(dt, level);
+  if (level == 0) {
+    parent->setCumTime(cumtime);
+  }
+
+  amrex::Print() << "Restarted level " << level << " from " << restart_delta
+                 << " (" << num_dirty << " boxes)" << std::endl;
+
+  // Applied once, by post_restart on each level in turn
+  if (level == finest_level) {
+    restart_delta.clear();
+  }
+}
+
 void
 PeleC::setPlotVariables()
 {
@@ -359,6 +650,16 @@ PeleC::setPlotVariables()
     amrex::Amr::addDerivePlotVar("WorkEstimate");
   }
 
+#ifdef PELEC_USE_REACTIONS
+  bool plot_chem_dt = false;
+  pp.query("plot_chem_dt", plot_chem_dt);
+  if (plot_chem_dt) {
+    amrex::Amr::addStatePlotVar(desc_lst[Chem_Dt_Type].name(0));
+  } else if (amrex::Amr::isStatePlotVar(desc_lst[Chem_Dt_Type].name(0))) {
+    amrex::Amr::deleteStatePlotVar(desc_lst[Chem_Dt_Type].name(0));
+  }
+#endif
+
   bool plot_rhoy = true;
   pp.query("plot_rhoy", plot_rhoy);
   if (plot_rhoy) {
@@ -749,6 +1050,193 @@ PeleC::writeBuildInfo(std::ostream& os)
   os << "\n\n";
 }
 
+namespace {
+using AsyncWriteFuture = decltype(amrex::VisMF::AsyncWrite(
+  std::declval<const amrex::MultiFab&>(), std::declval<const std::string&>()));
+
+// Plotfile writes handed to the background writer, oldest first
+std::deque<AsyncWriteFuture> pending_plot_writes;
+} // namespace
+
+void
+PeleC::writePlotMF(
+  const amrex::MultiFab& plotMF,
+  const amrex::Vector<std::string>& names,
+  const std::string& path,
+  amrex::VisMF::How how)
+{
+  if (plot_compress != 0) {
+    const int ncomp = plotMF.nComp();
+    amrex::Vector<amrex::Real> tol(ncomp, plot_compress_tol);
+    amrex::Vector<int> rel(ncomp, plot_compress_rel);
+    // Per variable: pelec.plot_compress_tol.<name> = <tol> [abs|rel]
+    amrex::ParmParse pp("pelec.plot_compress_tol");
+    for (int n = 0; n < ncomp; n++) {
+      const int nval = pp.countval(names[n].c_str());
+      if (nval == 0) {
+        continue;
+      }
+      pp.get(names[n].c_str(), tol[n], 0);
+      if (nval > 1) {
+        std::string mode;
+        pp.get(names[n].c_str(), mode, 1);
+        if (mode != "abs" && mode != "rel") {
+          amrex::Abort(
+            "pelec.plot_compress_tol." + names[n] + " must be abs or rel");
+        }
+        rel[n] = mode == "rel" ? 1 : 0;
+      }
+    }
+    pc_write_compressed_mf(plotMF, path, tol, rel);
+    return;
+  }
+
+  if (!amrex::AsyncOut::UseAsyncOut()) {
+    amrex::VisMF::Write(plotMF, path, how, true);
+    return;
+  }
+
+  // Each queued write holds a staged copy of its MultiFab, so bound the
+  // queue and wait for the oldest writes when it is full
+  const int max_pending = amrex::max(1, plot_async_depth);
+  if (static_cast<int>(pending_plot_writes.size()) >= max_pending) {
+    amrex::Real stall = amrex::ParallelDescriptor::second();
+    while (static_cast<int>(pending_plot_writes.size()) >= max_pending) {
+      pending_plot_writes.front().wait();
+      pending_plot_writes.pop_front();
+    }
+    stall = amrex::ParallelDescriptor::second() - stall;
+    if (verbose > 0) {
+      amrex::ParallelDescriptor::ReduceRealMax(
+        stall, amrex::ParallelDescriptor::IOProcessorNumber());
+      amrex::Print() << "Plotfile write queue full, stalled for " << stall
+                     << " s" << std::endl;
+    }
+  }
+
+  // AsyncWrite copies plotMF before returning
+  pending_plot_writes.push_back(amrex::VisMF::AsyncWrite(plotMF, path, true));
+}
+
+void
+PeleC::derivePlotVars(
+  amrex::MultiFab& plotMF,
+  int dcomp,
+  const amrex::Vector<std::string>& names,
+  amrex::Real time)
+{
+  BL_PROFILE("PeleC::derivePlotVars()");
+
+  const amrex::MultiFab& S_new = get_new_data(State_Type);
+  AMREX_ALWAYS_ASSERT(time == state[State_Type].curTime());
+
+  // Cached derives come from the primitives, computed once. Derives
+  // that take the whole state read one shared source, which is the
+  // state itself when no ghost cells are needed. Others go through
+  // AmrLevel::derive.
+  const int nderive = names.size();
+  amrex::Vector<int> prim_id(nderive, -1);
+  amrex::Vector<int> shared(nderive, 0);
+  bool need_prim = false;
+  bool need_eos = false;
+  int ngrow_src = -1;
+  int n = 0;
+  for (const auto& name : names) {
+    const amrex::DeriveRec* rec = derive_lst.get(name);
+    prim_id[n] = pc_plot_prim_derive(name);
+    if (prim_id[n] >= 0) {
+      need_prim = true;
+      need_eos = need_eos || pc_plot_prim_needs_eos(prim_id[n]);
+    } else if (rec->derFuncFab() != nullptr && rec->numRange() == 1) {
+      int idx;
+      int scomp;
+      int ncomp;
+      rec->getRange(0, idx, scomp, ncomp);
+      if (idx == State_Type && scomp == Density && ncomp == NVAR) {
+        const amrex::Box& bx = grids[0];
+        const int ngrow = bx.smallEnd(0) - rec->boxMap()(bx).smallEnd(0);
+        ngrow_src = amrex::max(ngrow_src, ngrow);
+        shared[n] = 1;
+      }
+    }
+    n++;
+  }
+
+  amrex::Vector<amrex::Real> run_time(nderive + 1, 0.0);
+  amrex::Real strt_time = amrex::ParallelDescriptor::second();
+
+  amrex::MultiFab prim;
+  if (need_prim) {
+    prim.define(grids, dmap, PP_NUM, 0, amrex::MFInfo(), Factory());
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(prim, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      pc_derplotprim(mfi.tilebox(), prim[mfi], S_new[mfi], need_eos);
+    }
+  }
+
+  amrex::MultiFab filled;
+  if (ngrow_src > 0) {
+    filled.define(grids, dmap, NVAR, ngrow_src, amrex::MFInfo(), Factory());
+    FillPatch(*this, filled, ngrow_src, time, State_Type, Density, NVAR);
+  }
+  const amrex::MultiFab& src = ngrow_src > 0 ? filled : S_new;
+  run_time[nderive] = amrex::ParallelDescriptor::second() - strt_time;
+
+  n = 0;
+  for (const auto& name : names) {
+    strt_time = amrex::ParallelDescriptor::second();
+    const amrex::DeriveRec* rec = derive_lst.get(name);
+    const int ncomp = rec->numDerive();
+    if (prim_id[n] >= 0) {
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+      for (amrex::MFIter mfi(plotMF, amrex::TilingIfNotGPU()); mfi.isValid();
+           ++mfi) {
+        pc_derfromprim(
+          mfi.tilebox(), plotMF[mfi], dcomp, prim[mfi], S_new[mfi],
+          prim_id[n]);
+      }
+    } else if (shared[n] != 0) {
+      // Write straight into plotMF through an alias of its components
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+      for (amrex::MFIter mfi(plotMF, amrex::TilingIfNotGPU()); mfi.isValid();
+           ++mfi) {
+        amrex::FArrayBox derfab(plotMF[mfi], amrex::make_alias, dcomp, ncomp);
+        rec->derFuncFab()(
+          mfi.tilebox(), derfab, 0, ncomp, src[mfi], geom, time, rec->getBC(),
+          level);
+      }
+    } else {
+      auto derive_dat = derive(name, time, 0);
+      amrex::MultiFab::Copy(plotMF, *derive_dat, 0, dcomp, ncomp, 0);
+    }
+    amrex::Gpu::streamSynchronize();
+    run_time[n] = amrex::ParallelDescriptor::second() - strt_time;
+    dcomp += ncomp;
+    n++;
+  }
+
+  if (verbose > 1) {
+    const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
+    amrex::ParallelDescriptor::ReduceRealMax(
+      run_time.data(), run_time.size(), IOProc);
+    amrex::Print() << "PeleC::derivePlotVars() level " << level
+                   << ": primitives and source " << run_time[nderive] << "\n";
+    for (n = 0; n < nderive; n++) {
+      amrex::Print() << "  " << names[n] << " "
+                     << (prim_id[n] >= 0 ? "(cached) "
+                                         : shared[n] != 0 ? "(shared) " : "")
+                     << run_time[n] << "\n";
+    }
+  }
+}
+
 void
 PeleC::writePlotFile(
   const std::string& dir, std::ostream& os, amrex::VisMF::How how)
@@ -927,14 +1415,9 @@ PeleC::writePlotFile(
 
   // Cull data from derived variables.
   if (!derive_names.empty()) {
-    for (const auto& derive_name : derive_names) {
-      const amrex::DeriveRec* rec = derive_lst.get(derive_name);
-      int ncomp = rec->numDerive();
-
-      auto derive_dat = derive(derive_name, cur_time, nGrow);
-      amrex::MultiFab::Copy(plotMF, *derive_dat, 0, cnt, ncomp, nGrow);
-      cnt += ncomp;
-    }
+    const amrex::Vector<std::string> names(
+      derive_names.begin(), derive_names.end());
+    derivePlotVars(plotMF, cnt, names, cur_time);
   }
 
 #ifdef PELEC_USE_EB
@@ -942,10 +1425,21 @@ PeleC::writePlotFile(
   // amrex::EB_set_covered(plotMF);
 #endif
 
+  amrex::Vector<std::string> plot_names;
+  for (const auto& pv : plot_var_map) {
+    plot_names.push_back(desc_lst[pv.first].name(pv.second));
+  }
+  for (const auto& derive_name : derive_names) {
+    const amrex::DeriveRec* rec = derive_lst.get(derive_name);
+    for (int i = 0; i < rec->numDerive(); i++) {
+      plot_names.push_back(rec->variableName(i));
+    }
+  }
+
   // Use the Full pathname when naming the MultiFab.
   std::string TheFullPath = FullPath;
   TheFullPath += BaseName;
-  amrex::VisMF::Write(plotMF, TheFullPath, how, true);
+  writePlotMF(plotMF, plot_names, TheFullPath, how);
 #ifdef AMREX_PARTICLES
   bool is_checkpoint = false;
 
@@ -969,8 +1463,12 @@ PeleC::writePlotFile(
           // TODO: Would be nice to be able to use file_name_digits instead of
           // doing this
           int strlen = dir.length();
-          // Remove the ".temp" from the directory
-          std::string dirout = dir.substr(0, strlen - 5);
+          // Remove the ".temp" from the directory, which is not used with
+          // asynchronous output
+          std::string dirout = dir;
+          if (strlen > 5 && dir.compare(strlen - 5, 5, ".temp") == 0) {
+            dirout = dir.substr(0, strlen - 5);
+          }
           size_t num_start_loc = dirout.find_last_not_of("0123456789") + 1;
           std::string fname =
             "spray" + dirout.substr(num_start_loc, strlen) + ".p3d";
@@ -1123,8 +1621,13 @@ PeleC::writeSmallPlotFile(
     cnt++;
   }
 
+  amrex::Vector<std::string> plot_names;
+  for (const auto& pv : plot_var_map) {
+    plot_names.push_back(desc_lst[pv.first].name(pv.second));
+  }
+
   // Use the Full pathname when naming the MultiFab.
   std::string TheFullPath = FullPath;
   TheFullPath += BaseName;
-  amrex::VisMF::Write(plotMF, TheFullPath, how, true);
+  writePlotMF(plotMF, plot_names, TheFullPath, how);
 }
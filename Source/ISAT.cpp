@@ -0,0 +1,195 @@
+#include <AMReX_BLassert.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include "ISAT.H"
+
+ISATTable::ISATTable(
+  int nin, int nout, amrex::Real tol, amrex::Long max_bytes)
+  : m_nin(nin), m_nout(nout), m_tol(tol), m_max_bytes(max_bytes)
+{
+  AMREX_ALWAYS_ASSERT(nin > 0 && nout > 0 && tol > 0.0);
+  // x, f and M of the record, plus the cutting plane of its parent node
+  m_record_bytes =
+    (2 * nin + nout + nin * nin) * sizeof(amrex::Real) + 2 * sizeof(Node);
+}
+
+amrex::Long
+ISATTable::numRecords() const
+{
+  std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+  return m_records.size();
+}
+
+amrex::Long
+ISATTable::numBytes() const
+{
+  return numRecords() * m_record_bytes;
+}
+
+int
+ISATTable::find_leaf(const amrex::Real* x) const
+{
+  int n = m_root;
+  while (n >= 0 && m_nodes[n].record < 0) {
+    const Node& node = m_nodes[n];
+    amrex::Real vx = 0.0;
+    for (int d = 0; d < m_nin; d++) {
+      vx += node.v[d] * x[d];
+    }
+    n = vx > node.a ? node.right : node.left;
+  }
+  return n;
+}
+
+amrex::Real
+ISATTable::eoa_distance(const Record& r, const amrex::Real* x) const
+{
+  amrex::Real dist = 0.0;
+  for (int d1 = 0; d1 < m_nin; d1++) {
+    const amrex::Real* Mrow = &r.M[d1 * m_nin];
+    amrex::Real Mp = 0.0;
+    for (int d2 = 0; d2 < m_nin; d2++) {
+      Mp += Mrow[d2] * (x[d2] - r.x[d2]);
+    }
+    dist += (x[d1] - r.x[d1]) * Mp;
+  }
+  return dist;
+}
+
+bool
+ISATTable::retrieve(const amrex::Real* x, amrex::Real* f)
+{
+  m_queries++;
+
+  std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+  const int leaf = find_leaf(x);
+  if (leaf < 0) {
+    return false;
+  }
+  const Record& r = m_records[m_nodes[leaf].record];
+  if (eoa_distance(r, x) > 1.0) {
+    return false;
+  }
+  for (int n = 0; n < m_nout; n++) {
+    f[n] = r.f[n];
+  }
+  m_retrieves++;
+  return true;
+}
+
+void
+ISATTable::update(const amrex::Real* x, const amrex::Real* f)
+{
+  std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+
+  // The tree may have changed since the retrieval failed
+  const int leaf = find_leaf(x);
+  if (leaf >= 0) {
+    Record& r = m_records[m_nodes[leaf].record];
+    const amrex::Real dist = eoa_distance(r, x);
+    if (dist <= 1.0) {
+      return;
+    }
+    amrex::Real err = 0.0;
+    for (int n = 0; n < m_nout; n++) {
+      err += (f[n] - r.f[n]) * (f[n] - r.f[n]);
+    }
+    if (err <= m_tol * m_tol) {
+      grow(r, x);
+      m_growths++;
+      return;
+    }
+  }
+
+  const amrex::Long nrec = m_records.size();
+  if ((nrec + 1) * m_record_bytes <= m_max_bytes) {
+    add(leaf, x, f);
+    m_adds++;
+  }
+}
+
+void
+ISATTable::grow(Record& r, const amrex::Real* x)
+{
+  // Smallest ellipsoid centered on x0 containing the EOA and x:
+  //   M' = M - (1 - 1/g2)/g2 (M p)(M p)^T, p = x - x0, g2 = p^T M p
+  amrex::Vector<amrex::Real> Mp(m_nin, 0.0);
+  amrex::Real g2 = 0.0;
+  for (int d1 = 0; d1 < m_nin; d1++) {
+    for (int d2 = 0; d2 < m_nin; d2++) {
+      Mp[d1] += r.M[d1 * m_nin + d2] * (x[d2] - r.x[d2]);
+    }
+    g2 += (x[d1] - r.x[d1]) * Mp[d1];
+  }
+  const amrex::Real fac = (1.0 - 1.0 / g2) / g2;
+  for (int d1 = 0; d1 < m_nin; d1++) {
+    for (int d2 = 0; d2 < m_nin; d2++) {
+      r.M[d1 * m_nin + d2] -= fac * Mp[d1] * Mp[d2];
+    }
+  }
+}
+
+void
+ISATTable::add(int leaf, const amrex::Real* x, const amrex::Real* f)
+{
+  Record r;
+  r.x.assign(x, x + m_nin);
+  r.f.assign(f, f + m_nout);
+  r.M.assign(m_nin * m_nin, 0.0);
+  for (int d = 0; d < m_nin; d++) {
+    r.M[d * m_nin + d] = 1.0 / (m_tol * m_tol);
+  }
+  m_records.push_back(std::move(r));
+
+  Node new_leaf;
+  new_leaf.record = m_records.size() - 1;
+  m_nodes.push_back(new_leaf);
+  const int new_node = m_nodes.size() - 1;
+
+  if (leaf < 0) {
+    m_root = new_node;
+    return;
+  }
+
+  // Split the leaf we ended up in: it becomes the parent of its old record
+  // and of the new one, separated by the plane halfway between them
+  Node old_leaf;
+  old_leaf.record = m_nodes[leaf].record;
+  m_nodes.push_back(old_leaf);
+  const int old_node = m_nodes.size() - 1;
+
+  const amrex::Vector<amrex::Real>& x_old = m_records[old_leaf.record].x;
+  Node& parent = m_nodes[leaf];
+  parent.record = -1;
+  parent.left = old_node;
+  parent.right = new_node;
+  parent.v.resize(m_nin);
+  parent.a = 0.0;
+  for (int d = 0; d < m_nin; d++) {
+    parent.v[d] = x[d] - x_old[d];
+    parent.a += parent.v[d] * 0.5 * (x[d] + x_old[d]);
+  }
+}
+
+void
+ISATTable::clear()
+{
+  std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+  m_records.clear();
+  m_nodes.clear();
+  m_root = -1;
+}
+
+void
+ISATTable::printStats() const
+{
+  amrex::Long stats[6] = {numQueries(), numRetrieves(), numGrowths(),
+                          numAdds(),    numRecords(),   numBytes()};
+  amrex::ParallelDescriptor::ReduceLongSum(
+    stats, 6, amrex::ParallelDescriptor::IOProcessorNumber());
+  amrex::Print() << "ISAT: " << stats[0] << " queries, " << stats[1]
+                 << " retrieves, " << stats[2] << " growths, " << stats[3]
+                 << " adds, " << stats[4] << " records (" << stats[5]
+                 << " bytes)" << std::endl;
+}
@@ -1,5 +1,8 @@
+#include <map>
 #include <memory>
 
+#include <AMReX_Scan.H>
+
 #include "EB.H"
 #include "prob.H"
 #include "Utilities.H"
@@ -10,6 +13,34 @@
 #include <thrust/execution_policy.h>
 #endif
 
+namespace {
+// Lexicographic order on the box corners
+struct BoxLess
+{
+  bool operator()(const amrex::Box& a, const amrex::Box& b) const
+  {
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      if (a.smallEnd(dir) != b.smallEnd(dir)) {
+        return a.smallEnd(dir) < b.smallEnd(dir);
+      }
+    }
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      if (a.bigEnd(dir) != b.bigEnd(dir)) {
+        return a.bigEnd(dir) < b.bigEnd(dir);
+      }
+    }
+    return false;
+  }
+};
+
+// Stencils of the local cut boxes of each level, keyed by valid box. The
+// levels own the entries: a box that survives a regrid is found while the
+// level being replaced still exists, and its entry expires with it.
+amrex::Vector<
+  std::map<amrex::Box, std::weak_ptr<const EBBoxStencils>, BoxLess>>
+  eb_stencil_cache;
+} // namespace
+
 inline bool
 PeleC::ebInitialized()
 {
@@ -30,7 +61,8 @@ PeleC::init_eb(
 // At the end of this routine, the following structures are populated:
 //   - FabArray ebmask
 //  - MultiFAB vfrac
-//  - sv_eb_bndry_geom
+//  - eb_stencils (compressed cut-cell data), sv_eb_flux, sv_eb_bcval
+// The stencils of boxes already built on this level and rank are reused
 
 void
 PeleC::initialize_eb2_structs()
@@ -40,7 +72,7 @@ PeleC::initialize_eb2_structs()
 
   // NOTE: THIS NEEDS TO BE REPLACED WITH A FLAGFAB
 
-  // 1->regular, 0->irregular, -1->covered, 2->outside
+  // 1->regular, 0->irregular, -1->covered
   ebmask.define(grids, dmap, 1, 0);
 
   static_assert(
@@ -62,9 +94,8 @@ PeleC::initialize_eb2_structs()
   eb2areafrac = ebfactory.getAreaFrac();
   facecent = ebfactory.getFaceCent();
 
-  // First pass over fabs to fill sparse per cut-cell ebg structures
-  sv_eb_bndry_geom.resize(vfrac.local_size());
-  sv_eb_bndry_grad_stencil.resize(vfrac.local_size());
+  sv_eb_flux.clear();
+  sv_eb_bcval.clear();
   sv_eb_flux.resize(vfrac.local_size());
   sv_eb_bcval.resize(vfrac.local_size());
 
@@ -86,6 +117,37 @@ PeleC::initialize_eb2_structs()
     amrex::Abort();
   }
 
+  // Take the cached stencils of the boxes that are still here
+  if (static_cast<int>(eb_stencil_cache.size()) <= level) {
+    eb_stencil_cache.resize(level + 1);
+  }
+  auto& cache = eb_stencil_cache[level];
+  eb_stencils.clear();
+  eb_stencils.resize(vfrac.local_size());
+  for (amrex::MFIter mfi(vfrac, false); mfi.isValid(); ++mfi) {
+    auto it = cache.find(mfi.validbox());
+    if (it != cache.end()) {
+      eb_stencils[mfi.LocalIndex()] = it->second.lock();
+    }
+  }
+  const auto no_stencils = std::make_shared<const EBBoxStencils>();
+
+  // Face boxes of the flux interpolation stencils
+  amrex::Box fbox[AMREX_SPACEDIM];
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    fbox[dir] = amrex::bdryLo(
+      amrex::Box(
+        amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
+        amrex::IntVect(AMREX_D_DECL(0, 0, 0))),
+      dir, 1);
+
+    for (int dir1 = 0; dir1 < AMREX_SPACEDIM; ++dir1) {
+      if (dir1 != dir) {
+        fbox[dir].grow(dir1, 1);
+      }
+    }
+  }
+
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -99,97 +161,168 @@ PeleC::initialize_eb2_structs()
 
     if (typ == amrex::FabType::regular) {
       mfab.setVal<amrex::RunOn::Device>(1);
+      eb_stencils[iLocal] = no_stencils;
     } else if (typ == amrex::FabType::covered) {
       mfab.setVal<amrex::RunOn::Device>(-1);
+      eb_stencils[iLocal] = no_stencils;
     } else if (typ == amrex::FabType::singlevalued) {
-      int Ncut = 0;
-      for (amrex::BoxIterator bit(tbox); bit.ok(); ++bit) {
-        const amrex::EBCellFlag& flag = flagfab(bit(), 0);
+      const auto& flag_arr = flagfab.const_array();
+      const auto& mask = mfab.array();
+      amrex::ParallelFor(
+        mfab.box(), [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::EBCellFlag& flag = flag_arr(i, j, k);
+          mask(i, j, k) = flag.isRegular() ? 1 : (flag.isCovered() ? -1 : 0);
+        });
 
-        if (!(flag.isRegular() || flag.isCovered())) {
-          Ncut++;
-        }
-      }
+      if (!eb_stencils[iLocal]) {
+        auto ebs = std::make_shared<EBBoxStencils>();
 
-      sv_eb_bndry_geom[iLocal].resize(Ncut);
-      int ivec = 0;
-      for (amrex::BoxIterator bit(tbox); bit.ok(); ++bit) {
-        const amrex::EBCellFlag& flag = flagfab(bit(), 0);
-
-        if (!(flag.isRegular() || flag.isCovered())) {
-          EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom[iLocal].data();
-          amrex::IntVect captured_bit = bit();
-          // Serial loop on the GPU
-          amrex::ParallelFor(1, [=] AMREX_GPU_DEVICE(int /*dummy*/) {
-            d_sv_eb_bndry_geom[ivec].iv = captured_bit;
+        // Compact the cut cells of the grown box
+        const int npts = tbox.numPts();
+        const int Ncut = amrex::Reduce::Sum<int>(
+          npts, [=] AMREX_GPU_DEVICE(int n) noexcept -> int {
+            const amrex::EBCellFlag& flag = flag_arr(tbox.atOffset(n));
+            return !(flag.isRegular() || flag.isCovered());
           });
-          ivec++;
+        amrex::Gpu::DeviceVector<EBBndryGeom> sv_eb_bndry_geom(Ncut);
+        EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom.data();
+        amrex::Scan::PrefixSum<int>(
+          npts,
+          [=] AMREX_GPU_DEVICE(int n) -> int {
+            const amrex::EBCellFlag& flag = flag_arr(tbox.atOffset(n));
+            return !(flag.isRegular() || flag.isCovered());
+          },
+          [=] AMREX_GPU_DEVICE(int n, int const& icut) {
+            const amrex::IntVect iv = tbox.atOffset(n);
+            const amrex::EBCellFlag& flag = flag_arr(iv);
+            if (!(flag.isRegular() || flag.isCovered())) {
+              d_sv_eb_bndry_geom[icut].iv = iv;
+            }
+          },
+          amrex::Scan::Type::exclusive);
+
+        // Now fill the sv_eb_bndry_geom
+        auto const& vfrac_arr = vfrac.array(mfi);
+        auto const& bndrycent_arr = bndrycent->array(mfi);
+        AMREX_D_TERM(
+          auto const& eb2areafrac_arr_0 = eb2areafrac[0]->array(mfi);
+          , auto const& eb2areafrac_arr_1 = eb2areafrac[1]->array(mfi);
+          , auto const& eb2areafrac_arr_2 = eb2areafrac[2]->array(mfi);)
+        pc_fill_sv_ebg(
+          tbox, Ncut, vfrac_arr, bndrycent_arr,
+          AMREX_D_DECL(eb2areafrac_arr_0, eb2areafrac_arr_1, eb2areafrac_arr_2),
+          d_sv_eb_bndry_geom);
+
+        amrex::Gpu::DeviceVector<EBBndrySten> sv_eb_bndry_grad_stencil(Ncut);
+
+        // Fill in boundary gradient for cut cells in this grown tile
+        const amrex::Real dx = geom.CellSize()[0];
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+        thrust::sort(
+          thrust::device, d_sv_eb_bndry_geom, d_sv_eb_bndry_geom + Ncut,
+          EBBndryGeomCmp());
+#else
+        sort<amrex::Gpu::DeviceVector<EBBndryGeom>>(sv_eb_bndry_geom);
+#endif
 
-          if (mfab.box().contains(bit())) {
-            mfab(bit()) = 0;
-          }
+        if (bgs == 0) {
+          pc_fill_bndry_grad_stencil_quadratic(
+            tbox, dx, Ncut, d_sv_eb_bndry_geom, Ncut,
+            sv_eb_bndry_grad_stencil.data());
+        } else if (bgs == 1) {
+          pc_fill_bndry_grad_stencil_ls(
+            tbox, dx, Ncut, d_sv_eb_bndry_geom, Ncut, flags.array(mfi),
+            sv_eb_bndry_grad_stencil.data());
         } else {
-          if (flag.isRegular()) {
-            if (mfab.box().contains(bit())) {
-              mfab(bit()) = 1;
-            }
-          } else if (flag.isCovered()) {
-            if (mfab.box().contains(bit())) {
-              mfab(bit()) = -1;
-            }
-          } else {
-            if (mfab.box().contains(bit())) {
-              mfab(bit()) = 2;
-            }
-          }
+          amrex::Print()
+            << "Unknown or unspecified boundary gradient stencil type:" << bgs
+            << std::endl;
+          amrex::Abort();
         }
-      }
-
-      // int Nebg = sv_eb_bndry_geom[iLocal].size();
-
-      // Now fill the sv_eb_bndry_geom
-      auto const& vfrac_arr = vfrac.array(mfi);
-      auto const& bndrycent_arr = bndrycent->array(mfi);
-      AMREX_D_TERM(auto const& eb2areafrac_arr_0 = eb2areafrac[0]->array(mfi);
-                   , auto const& eb2areafrac_arr_1 = eb2areafrac[1]->array(mfi);
-                   ,
-                   auto const& eb2areafrac_arr_2 = eb2areafrac[2]->array(mfi);)
-      pc_fill_sv_ebg(
-        tbox, Ncut, vfrac_arr, bndrycent_arr,
-        AMREX_D_DECL(eb2areafrac_arr_0, eb2areafrac_arr_1, eb2areafrac_arr_2),
-        sv_eb_bndry_geom[iLocal].data());
 
-      sv_eb_bndry_grad_stencil[iLocal].resize(Ncut);
+        // Flux interpolation stencils on the cut faces of the cut cells
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+          const auto afrac_arr = (*eb2areafrac[dir])[mfi].array();
+          const auto facecent_arr = (*facecent[dir])[mfi].array();
+
+          // This used to be an std::set for cut_faces (it ensured
+          // sorting and uniqueness)
+          amrex::Gpu::DeviceVector<amrex::IntVect> v_all_cut_faces(2 * Ncut);
+          amrex::IntVect* all_cut_faces = v_all_cut_faces.data();
+          const int Nall_cut_faces = amrex::Scan::PrefixSum<int>(
+            Ncut,
+            [=] AMREX_GPU_DEVICE(int i) -> int {
+              int r = 0;
+              const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
+              for (int iside = 0; iside <= 1; iside++) {
+                const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
+                if (afrac_arr(iv_face) < 1.0) {
+                  r++;
+                }
+              }
+              return r;
+            },
+            [=] AMREX_GPU_DEVICE(int i, int const& offset) {
+              int cnt = offset;
+              const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
+              for (int iside = 0; iside <= 1; iside++) {
+                const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
+                if (afrac_arr(iv_face) < 1.0) {
+                  all_cut_faces[cnt] = iv_face;
+                  cnt++;
+                }
+              }
+            },
+            amrex::Scan::Type::exclusive);
+          v_all_cut_faces.resize(Nall_cut_faces);
 
-      // Fill in boundary gradient for cut cells in this grown tile
-      const amrex::Real dx = geom.CellSize()[0];
 #if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
-      const int sv_eb_bndry_geom_size = sv_eb_bndry_geom[iLocal].size();
-      thrust::sort(
-        thrust::device, sv_eb_bndry_geom[iLocal].data(),
-        sv_eb_bndry_geom[iLocal].data() + sv_eb_bndry_geom_size,
-        EBBndryGeomCmp());
+          thrust::sort(
+            thrust::device, v_all_cut_faces.data(),
+            v_all_cut_faces.data() + Nall_cut_faces);
+          amrex::IntVect* unique_result_end = thrust::unique(
+            v_all_cut_faces.data(), v_all_cut_faces.data() + Nall_cut_faces,
+            thrust::equal_to<amrex::IntVect>());
+          const int count_result =
+            thrust::distance(v_all_cut_faces.data(), unique_result_end);
+          amrex::Gpu::DeviceVector<amrex::IntVect> v_cut_faces(count_result);
+          amrex::IntVect* d_all_cut_faces = v_all_cut_faces.data();
+          amrex::IntVect* d_cut_faces = v_cut_faces.data();
+          amrex::ParallelFor(
+            v_cut_faces.size(), [=] AMREX_GPU_DEVICE(int i) noexcept {
+              d_cut_faces[i] = d_all_cut_faces[i];
+            });
 #else
-      sort<amrex::Gpu::DeviceVector<EBBndryGeom>>(sv_eb_bndry_geom[iLocal]);
+          sort<amrex::Gpu::DeviceVector<amrex::IntVect>>(v_all_cut_faces);
+          amrex::Gpu::DeviceVector<amrex::IntVect> v_cut_faces =
+            unique<amrex::Gpu::DeviceVector<amrex::IntVect>>(v_all_cut_faces);
 #endif
 
-      if (bgs == 0) {
-        pc_fill_bndry_grad_stencil_quadratic(
-          tbox, dx, Ncut, sv_eb_bndry_geom[iLocal].data(), Ncut,
-          sv_eb_bndry_grad_stencil[iLocal].data());
-      } else if (bgs == 1) {
-        pc_fill_bndry_grad_stencil_ls(
-          tbox, dx, Ncut, sv_eb_bndry_geom[iLocal].data(), Ncut,
-          flags.array(mfi), sv_eb_bndry_grad_stencil[iLocal].data());
-      } else {
-        amrex::Print()
-          << "Unknown or unspecified boundary gradient stencil type:" << bgs
-          << std::endl;
-        amrex::Abort();
+          const int Nsten = v_cut_faces.size();
+          if (Nsten > 0) {
+            auto& stencil = ebs->flux_interp_stencil[dir];
+            stencil.resize(Nsten);
+
+            amrex::IntVect* cut_faces = v_cut_faces.data();
+            auto* d_flux_interp_stencil = stencil.data();
+            amrex::ParallelFor(Nsten, [=] AMREX_GPU_DEVICE(int i) noexcept {
+              d_flux_interp_stencil[i].iv = cut_faces[i];
+            });
+
+            pc_fill_flux_interp_stencil(
+              tbox, fbox[dir], Nsten, facecent_arr, afrac_arr, stencil.data());
+          }
+        }
+
+        // Keep the compressed form only
+        ebs->bndry.define(
+          d_sv_eb_bndry_geom, sv_eb_bndry_grad_stencil.data(), Ncut);
+        eb_stencils[iLocal] = ebs;
       }
 
-      sv_eb_flux[iLocal].define(sv_eb_bndry_grad_stencil[iLocal], NVAR);
-      sv_eb_bcval[iLocal].define(sv_eb_bndry_grad_stencil[iLocal], QVAR);
+      const int Ncut = eb_stencils[iLocal]->bndry.size();
+      sv_eb_flux[iLocal].define(Ncut, NVAR);
+      sv_eb_bcval[iLocal].define(Ncut, QVAR);
 
       if (eb_isothermal && (diffuse_temp != 0 || diffuse_enth != 0)) {
         sv_eb_bcval[iLocal].setVal(eb_boundary_T, QTEMP);
@@ -204,116 +337,18 @@ PeleC::initialize_eb2_structs()
     }
   }
 
-  // Second pass over dirs and fabs to fill flux interpolation stencils
-  amrex::Box fbox[AMREX_SPACEDIM];
-
-  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
-    flux_interp_stencil[dir].resize(vfrac.local_size());
-
-    fbox[dir] = amrex::bdryLo(
-      amrex::Box(
-        amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
-        amrex::IntVect(AMREX_D_DECL(0, 0, 0))),
-      dir, 1);
-
-    for (int dir1 = 0; dir1 < AMREX_SPACEDIM; ++dir1) {
-      if (dir1 != dir) {
-        fbox[dir].grow(dir1, 1);
-      }
+  // Drop the entries of the deleted levels and record the boxes built here
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->second.expired()) {
+      it = cache.erase(it);
+    } else {
+      ++it;
     }
-
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for (amrex::MFIter mfi(vfrac, false); mfi.isValid(); ++mfi) {
-      const amrex::Box tbox = mfi.growntilebox(numGrow());
-      const auto& flagfab = flags[mfi];
-      amrex::FabType typ = flagfab.getType(tbox);
-      int iLocal = mfi.LocalIndex();
-
-      if (typ == amrex::FabType::regular || typ == amrex::FabType::covered) {
-      } else if (typ == amrex::FabType::singlevalued) {
-        const auto afrac_arr = (*eb2areafrac[dir])[mfi].array();
-        const auto facecent_arr = (*facecent[dir])[mfi].array();
-
-        // This used to be an std::set for cut_faces (it ensured
-        // sorting and uniqueness)
-        EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom[iLocal].data();
-        const int Nall_cut_faces = amrex::Reduce::Sum<int>(
-          sv_eb_bndry_geom[iLocal].size(),
-          [=] AMREX_GPU_DEVICE(int i) noexcept -> int {
-            int r = 0;
-            const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
-            for (int iside = 0; iside <= 1; iside++) {
-              const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
-              if (afrac_arr(iv_face) < 1.0) {
-                r++;
-              }
-            }
-            return r;
-          });
-
-        amrex::Gpu::DeviceVector<amrex::IntVect> v_all_cut_faces(
-          Nall_cut_faces);
-        amrex::IntVect* all_cut_faces = v_all_cut_faces.data();
-
-        const int sv_eb_bndry_geom_size = sv_eb_bndry_geom[iLocal].size();
-        // Serial loop on the GPU
-        amrex::ParallelFor(1, [=] AMREX_GPU_DEVICE(int /*dummy*/) {
-          int cnt = 0;
-          for (int i = 0; i < sv_eb_bndry_geom_size; i++) {
-            const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
-            for (int iside = 0; iside <= 1; iside++) {
-              const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
-              if (afrac_arr(iv_face) < 1.0) {
-                all_cut_faces[cnt] = iv_face;
-                cnt++;
-              }
-            }
-          }
-        });
-
-#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
-        const int v_all_cut_faces_size = v_all_cut_faces.size();
-        thrust::sort(
-          thrust::device, v_all_cut_faces.data(),
-          v_all_cut_faces.data() + v_all_cut_faces_size);
-        amrex::IntVect* unique_result_end = thrust::unique(
-          v_all_cut_faces.data(), v_all_cut_faces.data() + v_all_cut_faces_size,
-          thrust::equal_to<amrex::IntVect>());
-        const int count_result =
-          thrust::distance(v_all_cut_faces.data(), unique_result_end);
-        amrex::Gpu::DeviceVector<amrex::IntVect> v_cut_faces(count_result);
-        amrex::IntVect* d_all_cut_faces = v_all_cut_faces.data();
-        amrex::IntVect* d_cut_faces = v_cut_faces.data();
-        amrex::ParallelFor(
-          v_cut_faces.size(), [=] AMREX_GPU_DEVICE(int i) noexcept {
-            d_cut_faces[i] = d_all_cut_faces[i];
-          });
-#else
-        sort<amrex::Gpu::DeviceVector<amrex::IntVect>>(v_all_cut_faces);
-        amrex::Gpu::DeviceVector<amrex::IntVect> v_cut_faces =
-          unique<amrex::Gpu::DeviceVector<amrex::IntVect>>(v_all_cut_faces);
-#endif
-
-        const int Nsten = v_cut_faces.size();
-        if (Nsten > 0) {
-          flux_interp_stencil[dir][iLocal].resize(Nsten);
-
-          amrex::IntVect* cut_faces = v_cut_faces.data();
-          auto* d_flux_interp_stencil = flux_interp_stencil[dir][iLocal].data();
-          amrex::ParallelFor(
-            v_cut_faces.size(), [=] AMREX_GPU_DEVICE(int i) noexcept {
-              d_flux_interp_stencil[i].iv = cut_faces[i];
-            });
-
-          pc_fill_flux_interp_stencil(
-            tbox, fbox[dir], Nsten, facecent_arr, afrac_arr,
-            flux_interp_stencil[dir][iLocal].data());
-        }
-      } else {
-        amrex::Abort("multi-valued flux interp stencil to be implemented");
-      }
+  }
+  for (amrex::MFIter mfi(vfrac, false); mfi.isValid(); ++mfi) {
+    const auto& ebs = eb_stencils[mfi.LocalIndex()];
+    if (ebs != no_stencils) {
+      cache[mfi.validbox()] = ebs;
     }
   }
 }
@@ -91,6 +91,17 @@ PeleC::construct_new_les_source(
   getLESTerm(time, dt, *new_sources[les_src], flux_factor_new);
 }
 
+int
+PeleC::nGrowLES() const
+{
+  if (les_model == 1) {
+    // nGrowD + nGrowC + nGrowT + 1 of getDynamicSmagorinskyLESTerm
+    return les_coeff_filter.get_filter_ngrow() +
+           les_test_filter.get_filter_ngrow() + 2;
+  }
+  return 1;
+}
+
 // Calculate the LES term by calling an SFS model
 // Across all conserved state components, compute the LES "source term"
 //    = -Div(LESFlux).
@@ -198,8 +209,15 @@ PeleC::getSmagorinskyLESTerm(
     {AMREX_D_DECL(dx1, dx1, dx1)}};
   const amrex::Real* dxDp = &(dxD[0]);
 
-  amrex::MultiFab S(grids, dmap, NVAR, ngrow);
-  FillPatch(*this, S, ngrow, time, State_Type, 0, NVAR); // FIXME: time+dt?
+  // Use the state filled by the advance at this time, if any
+  amrex::MultiFab Sfill;
+  const amrex::MultiFab* Sptr = filledState(time, ngrow);
+  if (Sptr == nullptr) {
+    Sfill.define(grids, dmap, NVAR, ngrow, amrex::MFInfo(), Factory());
+    FillPatch(*this, Sfill, ngrow, time, State_Type, 0, NVAR);
+    Sptr = &Sfill;
+  }
+  const amrex::MultiFab& S = *Sptr;
 
   // Fetch some gpu arrays
   prefetchToDevice(S);
@@ -384,12 +402,12 @@ PeleC::getDynamicSmagorinskyLESTerm(
   /*
     Note on the grow cells:
     N + 0                             (cbox) |----->         LESTerm
-    N + 0**                           (ebox) |----->         flux_ec, coeff_ec, alphaij_ec, alpha_ec, flux_T_ec
+    N + 0**                           (ebox) |----->         flux_ec
     N + 1                            (g4box) |------>        filtered_coeff_cc [= LES_Coeffs]
-    N + 1 + nGrowC                   (g3box) |-------->      coeff_cc, filtered_(K, RUT, alphaij, alpha, flux_T)
-    N + 1 + nGrowC + nGrowD          (g2box) |---------->    filtered_(S, Q, Qaux)
-    N + 1 + nGrowC + nGrowT          (g1box) |----------->   K, RUT, alphaij, alpha, flux_T
-    N + 1 + nGrowC + nGrowT + nGrowD (g0box) |-------------> S, Q, Qaux
+    N + 1 + nGrowC                   (g3box) |-------->      coeff_cc, [filtered_(K, RUT, alphaij, alpha, flux_T)]
+    N + 1 + nGrowC + nGrowD          (g2box) |---------->    filtered_Q, (filtered_Qaux)
+    N + 1 + nGrowC + nGrowT          (g1box) |----------->   alphaij, alpha, flux_T, [K, RUT]
+    N + 1 + nGrowC + nGrowT + nGrowD (g0box) |-------------> S, Q, (Qaux)
        |----------------------------|
        This is the number of grow cells on each side
 
@@ -402,10 +420,15 @@ PeleC::getDynamicSmagorinskyLESTerm(
        are moved to edge/faces centers (ec) to calculate the fluxes. ec quantities have length N+1 in the face-normal 
        direction and length N in the other two directions.
 
+    Quantities in parentheses are only kept per cell in the kernels, and the ec values are computed in the
+    flux kernel. Quantities in brackets are handed back to the scratch pool as soon as they have been used,
+    K and RUT are computed one after the other. The filtered state is written into filtered_Q and turned into
+    primitives in place.
+
   */
   // clang-format on
-  Filter test_filter = Filter(les_test_filter_type, les_test_filter_fgr);
-  Filter coeff_filter = Filter(box, 6);
+  Filter& test_filter = les_test_filter;
+  Filter& coeff_filter = les_coeff_filter;
 
   const int nGrowD = 1;
   const int nGrowC = coeff_filter.get_filter_ngrow();
@@ -421,10 +444,16 @@ PeleC::getDynamicSmagorinskyLESTerm(
   const amrex::Real* dxDp = &(dxD[0]);
 
   // 1. Get state variable data
-  amrex::MultiFab S(grids, dmap, NVAR, nGrowD + nGrowC + nGrowT + 1);
-  FillPatch(
-    *this, S, nGrowD + nGrowC + nGrowT + 1, time, State_Type, 0,
-    NVAR); // FIXME: time+dt?
+  // Use the state filled by the advance at this time, if any
+  const int nGrowS = nGrowD + nGrowC + nGrowT + 1;
+  amrex::MultiFab Sfill;
+  const amrex::MultiFab* Sptr = filledState(time, nGrowS);
+  if (Sptr == nullptr) {
+    Sfill.define(grids, dmap, NVAR, nGrowS, amrex::MFInfo(), Factory());
+    FillPatch(*this, Sfill, nGrowS, time, State_Type, 0, NVAR);
+    Sptr = &Sfill;
+  }
+  const amrex::MultiFab& S = *Sptr;
   LES_Coeffs.setVal(0.0);
 
   // Fetch some gpu arrays
@@ -464,50 +493,31 @@ PeleC::getDynamicSmagorinskyLESTerm(
 #endif
 
       auto const& s = S.array(mfi);
-      int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(g0box, QVAR);
-      amrex::FArrayBox qaux(g0box, nqaux);
-      amrex::Elixir qeli = q.elixir();
-      amrex::Elixir qauxeli = qaux.elixir();
+      ScratchFab q(scratch_pool, g0box, QVAR);
       auto const& q_ar = q.array();
-      auto const& qauxar = qaux.array();
+      const PassMap* lpmap = d_pass_map;
+      const int captured_clean_massfrac = clean_massfrac;
 
       // 1. Get primitives, Q, including (Y, T, p, rho) from conserved state
-      // required for L term
+      // required for L term. Qaux is not needed and stays in registers.
       {
         BL_PROFILE("PeleC::ctoprim()");
-        const PassMap* lpmap = d_pass_map;
-        const int captured_clean_massfrac = clean_massfrac;
         amrex::ParallelFor(
           g0box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            amrex::Real qa[NQAUX];
             pc_ctoprim(
-              i, j, k, s, q_ar, qauxar, *lpmap, captured_clean_massfrac);
+              i, j, k, s, q_ar, pc_cell_array4(qa, i, j, k, NQAUX), *lpmap,
+              captured_clean_massfrac);
           });
       }
 
       // 2. Get dynamic Smagorinsky derived quantities after setting the
       // BC. These quantities need to be stored because we need to filter
       // them at the test filter level. All are located at cell centers.
-      const int upper_triangle_n =
-        static_cast<int>(0.5 * AMREX_SPACEDIM * (AMREX_SPACEDIM + 1));
-      amrex::FArrayBox K;
-      amrex::FArrayBox RUT;
-      amrex::FArrayBox alphaij;
-      amrex::FArrayBox alpha;
-      amrex::FArrayBox flux_T;
-      K.resize(g1box, upper_triangle_n);
-      RUT.resize(g1box, AMREX_SPACEDIM);
-      alphaij.resize(g1box, AMREX_SPACEDIM * AMREX_SPACEDIM);
-      alpha.resize(g1box, 1);
-      flux_T.resize(g1box, AMREX_SPACEDIM);
-      amrex::Elixir K_eli = K.elixir();
-      amrex::Elixir RUT_eli = RUT.elixir();
-      amrex::Elixir alphaij_eli = alphaij.elixir();
-      amrex::Elixir alpha_eli = alpha.elixir();
-      amrex::Elixir flux_T_eli = flux_T.elixir();
-
-      auto const& K_ar = K.array();
-      auto const& RUT_ar = RUT.array();
+      ScratchFab alphaij(scratch_pool, g1box, AMREX_SPACEDIM * AMREX_SPACEDIM);
+      ScratchFab alpha(scratch_pool, g1box, 1);
+      ScratchFab flux_T(scratch_pool, g1box, AMREX_SPACEDIM);
+
       auto const& alphaij_ar = alphaij.array();
       auto const& alpha_ar = alpha.array();
       auto const& flux_T_ar = flux_T.array();
@@ -517,74 +527,83 @@ PeleC::getDynamicSmagorinskyLESTerm(
         amrex::ParallelFor(
           g1box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
             pc_dynamic_smagorinsky_quantities(
-              i, j, k, q_ar, les_filter_fgr_local, dx, K_ar, RUT_ar, alphaij_ar,
-              alpha_ar, flux_T_ar);
-          });
-      }
-
-      // 3. Filter the state variables and the derived quantities at the
-      // test filter level - still at cell centers
-      amrex::FArrayBox filtered_S;
-      amrex::FArrayBox filtered_Q;
-      amrex::FArrayBox filtered_Qaux;
-      amrex::FArrayBox filtered_K;
-      amrex::FArrayBox filtered_RUT;
-      amrex::FArrayBox filtered_alphaij;
-      amrex::FArrayBox filtered_alpha;
-      amrex::FArrayBox filtered_flux_T;
-      filtered_S.resize(g2box, NVAR);
-      filtered_Q.resize(g2box, QVAR);
-      filtered_Qaux.resize(g2box, NQAUX > 0 ? NQAUX : 1);
-      filtered_K.resize(g3box, upper_triangle_n);
-      filtered_RUT.resize(g3box, AMREX_SPACEDIM);
-      filtered_alphaij.resize(g3box, AMREX_SPACEDIM * AMREX_SPACEDIM);
-      filtered_alpha.resize(g3box, 1);
-      filtered_flux_T.resize(g3box, AMREX_SPACEDIM);
-      amrex::Elixir filtered_S_eli = filtered_S.elixir();
-      amrex::Elixir filtered_Q_eli = filtered_Q.elixir();
-      amrex::Elixir filtered_Qaux_eli = filtered_Qaux.elixir();
-      amrex::Elixir filtered_K_eli = filtered_K.elixir();
-      amrex::Elixir filtered_RUT_eli = filtered_RUT.elixir();
-      amrex::Elixir filtered_alphaij_eli = filtered_alphaij.elixir();
-      amrex::Elixir filtered_alpha_eli = filtered_alpha.elixir();
-      amrex::Elixir filtered_flux_T_eli = filtered_flux_T.elixir();
-
-      auto const& filtered_S_ar = filtered_S.array();
-      auto const& filtered_Q_ar = filtered_Q.array();
-      auto const& filtered_Qaux_ar = filtered_Qaux.array();
-
-      const amrex::FArrayBox& Sfab = S[mfi];
-      test_filter.apply_filter(g2box, Sfab, filtered_S);
-      {
-        BL_PROFILE("PeleC::ctoprim()");
-        const PassMap* lpmap = d_pass_map;
-        const int captured_clean_massfrac = clean_massfrac;
-        amrex::ParallelFor(
-          g2box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(
-              i, j, k, filtered_S_ar, filtered_Q_ar, filtered_Qaux_ar, *lpmap,
-              captured_clean_massfrac);
+              i, j, k, q_ar, les_filter_fgr_local, dx, alphaij_ar, alpha_ar,
+              flux_T_ar);
           });
       }
-      test_filter.apply_filter(g3box, K, filtered_K);
-      test_filter.apply_filter(g3box, RUT, filtered_RUT);
-      test_filter.apply_filter(g3box, alphaij, filtered_alphaij);
-      test_filter.apply_filter(g3box, alpha, filtered_alpha);
-      test_filter.apply_filter(g3box, flux_T, filtered_flux_T);
 
-      // 4. Calculate the dynamic Smagorinsky coefficients - still at cell
-      // centers
+      // 3. Filter the derived quantities at the test filter level. Kij and
+      // RUT are only filtered, so each is computed into a temporary that is
+      // handed back to the pool once filtered.
       int do_harmonic = 1;
-      amrex::FArrayBox coeff_cc;
-      coeff_cc.resize(g3box, nCompC);
-      amrex::Elixir coeff_cc_eli = coeff_cc.elixir();
+      ScratchFab coeff_cc(scratch_pool, g3box, nCompC);
       auto const& coeff_cc_ar = coeff_cc.array();
-      auto const& filtered_K_ar = filtered_K.array();
-      auto const& filtered_RUT_ar = filtered_RUT.array();
-      auto const& filtered_alphaij_ar = filtered_alphaij.array();
-      auto const& filtered_alpha_ar = filtered_alpha.array();
-      auto const& filtered_flux_T_ar = filtered_flux_T.array();
       {
+        ScratchFab filtered_K(scratch_pool, g3box, 6);
+        {
+          ScratchFab K(scratch_pool, g1box, 6);
+          auto const& K_ar = K.array();
+          amrex::ParallelFor(
+            g1box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              amrex::Real Kij[6];
+              amrex::Real RU[AMREX_SPACEDIM];
+              pc_dynamic_smagorinsky_resolved(i, j, k, q_ar, Kij, RU);
+              for (int c = 0; c < 6; c++) {
+                K_ar(i, j, k, c) = Kij[c];
+              }
+            });
+          test_filter.apply_filter(g3box, K, filtered_K);
+        }
+        ScratchFab filtered_RUT(scratch_pool, g3box, AMREX_SPACEDIM);
+        {
+          ScratchFab RUT(scratch_pool, g1box, AMREX_SPACEDIM);
+          auto const& RUT_ar = RUT.array();
+          amrex::ParallelFor(
+            g1box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              amrex::Real Kij[6];
+              amrex::Real RU[AMREX_SPACEDIM];
+              pc_dynamic_smagorinsky_resolved(i, j, k, q_ar, Kij, RU);
+              for (int c = 0; c < AMREX_SPACEDIM; c++) {
+                RUT_ar(i, j, k, c) = RU[c];
+              }
+            });
+          test_filter.apply_filter(g3box, RUT, filtered_RUT);
+        }
+        ScratchFab filtered_alphaij(
+          scratch_pool, g3box, AMREX_SPACEDIM * AMREX_SPACEDIM);
+        ScratchFab filtered_alpha(scratch_pool, g3box, 1);
+        ScratchFab filtered_flux_T(scratch_pool, g3box, AMREX_SPACEDIM);
+        test_filter.apply_filter(g3box, alphaij, filtered_alphaij);
+        test_filter.apply_filter(g3box, alpha, filtered_alpha);
+        test_filter.apply_filter(g3box, flux_T, filtered_flux_T);
+
+        // 4. Filter the state variables at the test filter level and get the
+        // filtered primitives in the same fab, then calculate the dynamic
+        // Smagorinsky coefficients - still at cell centers
+        ScratchFab filtered_Q(scratch_pool, g2box, QVAR);
+        auto const& filtered_Q_ar = filtered_Q.array();
+        test_filter.apply_filter(g2box, S[mfi], filtered_Q, 0, NVAR, NVAR);
+        {
+          BL_PROFILE("PeleC::ctoprim()");
+          amrex::ParallelFor(
+            g2box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              amrex::Real u[NVAR];
+              for (int n = 0; n < NVAR; n++) {
+                u[n] = filtered_Q_ar(i, j, k, n);
+              }
+              amrex::Real qa[NQAUX];
+              pc_ctoprim(
+                i, j, k, pc_cell_array4<const amrex::Real>(u, i, j, k, NVAR),
+                filtered_Q_ar, pc_cell_array4(qa, i, j, k, NQAUX), *lpmap,
+                captured_clean_massfrac);
+            });
+        }
+
+        auto const& filtered_K_ar = filtered_K.const_array();
+        auto const& filtered_RUT_ar = filtered_RUT.const_array();
+        auto const& filtered_alphaij_ar = filtered_alphaij.const_array();
+        auto const& filtered_alpha_ar = filtered_alpha.const_array();
+        auto const& filtered_flux_T_ar = filtered_flux_T.const_array();
         const int les_test_filter_fgr_local = PeleC::les_test_filter_fgr;
         BL_PROFILE("PeleC::pc_dynamic_smagorinsky_coeffs()");
         amrex::ParallelFor(
@@ -603,89 +622,58 @@ PeleC::getDynamicSmagorinskyLESTerm(
 
       // 6. Get the SFS term
 
-      // First step: move everything needed to compute fluxes to ec (faces)
+      // Compute the fluxes at the faces, moving the coefficients and the
+      // stresses from the cell centers to each face on the fly
       const amrex::Box eboxes[AMREX_SPACEDIM] = {AMREX_D_DECL(
         amrex::surroundingNodes(cbox, 0), amrex::surroundingNodes(cbox, 1),
         amrex::surroundingNodes(cbox, 2))};
-      amrex::FArrayBox coeff_ec[AMREX_SPACEDIM];
-      amrex::FArrayBox alphaij_ec[AMREX_SPACEDIM];
-      amrex::FArrayBox alpha_ec[AMREX_SPACEDIM];
-      amrex::FArrayBox flux_T_ec[AMREX_SPACEDIM];
-      amrex::Elixir coeff_ec_eli[AMREX_SPACEDIM];
-      amrex::Elixir alphaij_ec_eli[AMREX_SPACEDIM];
-      amrex::Elixir alpha_ec_eli[AMREX_SPACEDIM];
-      amrex::Elixir flux_T_ec_eli[AMREX_SPACEDIM];
-      amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> coeff_ec_arr;
-      amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
-        alphaij_ec_arr;
-      amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> alpha_ec_arr;
-      amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flux_T_ec_arr;
-
-      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-        coeff_ec[dir].resize(eboxes[dir], nCompC);
-        alphaij_ec[dir].resize(eboxes[dir], AMREX_SPACEDIM);
-        alpha_ec[dir].resize(eboxes[dir], 1);
-        flux_T_ec[dir].resize(eboxes[dir], 1);
-        coeff_ec_arr[dir] = coeff_ec[dir].array();
-        alphaij_ec_arr[dir] = alphaij_ec[dir].array();
-        alpha_ec_arr[dir] = alpha_ec[dir].array();
-        flux_T_ec_arr[dir] = flux_T_ec[dir].array();
-        coeff_ec_eli[dir] = coeff_ec[dir].elixir();
-        alphaij_ec_eli[dir] = alphaij_ec[dir].elixir();
-        alpha_ec_eli[dir] = alpha_ec[dir].elixir();
-        flux_T_ec_eli[dir] = flux_T_ec[dir].elixir();
-        amrex::ParallelFor(
-          eboxes[dir], [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            amrex::Real c[nCompC] = {0.0};
-            for (int n = 0; n < nCompC; n++) {
-              pc_move_transcoefs_to_ec(
-                i, j, k, n, LES_Coeffs_ar, c, dir, do_harmonic);
-              coeff_ec_arr[dir](i, j, k, n) = c[n];
-            }
-
-            amrex::Real aijc[AMREX_SPACEDIM * AMREX_SPACEDIM] = {0.0};
-            for (int n = 0; n < AMREX_SPACEDIM; n++) {
-              pc_move_transcoefs_to_ec(
-                i, j, k, dir * AMREX_SPACEDIM + n, alphaij_ar, aijc, dir,
-                do_harmonic);
-              alphaij_ec_arr[dir](i, j, k, n) = aijc[dir * AMREX_SPACEDIM + n];
-            }
-
-            amrex::Real ac[1] = {0.0};
-            pc_move_transcoefs_to_ec(
-              i, j, k, 0, alpha_ar, ac, dir, do_harmonic);
-            alpha_ec_arr[dir](i, j, k, 0) = ac[0];
-
-            amrex::Real tc[1] = {0.0};
-            pc_move_transcoefs_to_ec(
-              i, j, k, 0, flux_T_ar, tc, dir, do_harmonic);
-            flux_T_ec_arr[dir](i, j, k, 0) = tc[0];
-          });
-      }
-
-      // Compute the fluxes at the faces: all values passed are at faces
-      // except for Q, V, and Lterm
-      amrex::FArrayBox flux_ec[AMREX_SPACEDIM];
-      amrex::Elixir flux_eli[AMREX_SPACEDIM];
+      ScratchFab flux_ec[AMREX_SPACEDIM];
       const amrex::GpuArray<
         const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
         a{{AMREX_D_DECL(
           area[0].array(mfi), area[1].array(mfi), area[2].array(mfi))}};
       amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flx;
       for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-        flux_ec[dir].resize(eboxes[dir], NVAR);
-        flux_eli[dir] = flux_ec[dir].elixir();
+        flux_ec[dir].define(scratch_pool, eboxes[dir], NVAR);
         flx[dir] = flux_ec[dir].array();
-        setV(eboxes[dir], NVAR, flx[dir], 0);
       }
       {
         BL_PROFILE("PeleC::pc_dynamic_smagorinsky_sfs_term()");
         for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
           amrex::ParallelFor(
             eboxes[dir], [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              amrex::Real c[nCompC] = {0.0};
+              for (int n = 0; n < nCompC; n++) {
+                pc_move_transcoefs_to_ec(
+                  i, j, k, n, LES_Coeffs_ar, c, dir, do_harmonic);
+              }
+
+              amrex::Real aijc[AMREX_SPACEDIM * AMREX_SPACEDIM] = {0.0};
+              for (int n = 0; n < AMREX_SPACEDIM; n++) {
+                pc_move_transcoefs_to_ec(
+                  i, j, k, dir * AMREX_SPACEDIM + n, alphaij_ar, aijc, dir,
+                  do_harmonic);
+              }
+
+              amrex::Real ac[1] = {0.0};
+              pc_move_transcoefs_to_ec(
+                i, j, k, 0, alpha_ar, ac, dir, do_harmonic);
+
+              amrex::Real tc[1] = {0.0};
+              pc_move_transcoefs_to_ec(
+                i, j, k, 0, flux_T_ar, tc, dir, do_harmonic);
+
+              for (int n = 0; n < NVAR; n++) {
+                flx[dir](i, j, k, n) = 0.0;
+              }
               pc_dynamic_smagorinsky_sfs_term(
-                i, j, k, q_ar, alphaij_ec_arr[dir], alpha_ec_arr[dir],
-                flux_T_ec_arr[dir], coeff_ec_arr[dir], a[dir], dir, flx[dir]);
+                i, j, k, q_ar,
+                pc_cell_array4<const amrex::Real>(
+                  aijc + dir * AMREX_SPACEDIM, i, j, k, AMREX_SPACEDIM),
+                pc_cell_array4<const amrex::Real>(ac, i, j, k, 1),
+                pc_cell_array4<const amrex::Real>(tc, i, j, k, 1),
+                pc_cell_array4<const amrex::Real>(c, i, j, k, nCompC), a[dir],
+                dir, flx[dir]);
             });
         }
       }
@@ -482,6 +482,35 @@ PeleC::particleRedistribute(int lbase, int nGrow, int local, bool init_part)
   }
 }
 
+// The spray work is not measured box by box, so the time spent on this
+// level is split between the local boxes in proportion to their particles
+void
+PeleC::add_spray_work_estimate(Real wt)
+{
+  BL_PROFILE("PeleC::add_spray_work_estimate()");
+
+  const bool only_valid = true;
+  const bool only_local = true;
+  const Vector<Long> npart =
+    theSprayPC()->NumberOfParticlesInGrid(level, only_valid, only_local);
+
+  MultiFab& work = get_new_data(Work_Estimate_Type);
+  Long npart_local = 0;
+  for (MFIter mfi(work); mfi.isValid(); ++mfi) {
+    npart_local += npart[mfi.index()];
+  }
+  if (npart_local == 0) {
+    return;
+  }
+
+  for (MFIter mfi(work); mfi.isValid(); ++mfi) {
+    const Box& bx = mfi.validbox();
+    const Real wt_cell =
+      wt * npart[mfi.index()] / (npart_local * bx.d_numPts());
+    work[mfi].plus<RunOn::Device>(wt_cell, bx);
+  }
+}
+
 void
 PeleC::particleTimestamp(int ngrow)
 {
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <memory>
+#include <type_traits>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -28,6 +30,9 @@ using namespace MASA;
 #include "Utilities.H"
 #include "Tagging.H"
 #include "IndexDefines.H"
+#ifdef PELEC_USE_REACTIONS
+#include "React.H"
+#endif
 #if defined(PELEC_USE_REACTIONS) && defined(USE_SUNDIALS_PP)
 #include "reactor.H"
 #endif
@@ -96,11 +101,27 @@ amrex::GpuArray<amrex::Real, NVAR> PeleC::body_state;
 
 bool PeleC::do_react_load_balance = false;
 bool PeleC::do_mol_load_balance = false;
+amrex::Vector<int> PeleC::rebalance_levels;
 
 amrex::Vector<std::string> PeleC::spec_names;
 
 amrex::Vector<int> PeleC::src_list;
 
+amrex::Vector<int> PeleC::sum_iq_list;
+
+SamplingParm PeleC::sampling_parm;
+
+PerfLog PeleC::perf_log;
+
+amrex::Vector<std::unique_ptr<amrex::MultiFab>> PeleC::ckpt_base;
+std::string PeleC::ckpt_base_name;
+int PeleC::ckpt_num_delta = 0;
+
+
+#ifdef PELEC_USE_REACTIONS
+std::unique_ptr<ISATTable> PeleC::isat_table;
+#endif
+
 // this will be reset upon restart
 amrex::Real PeleC::previousCPUTimeUsed = 0.0;
 amrex::Real PeleC::startCPUTime = 0.0;
@@ -141,6 +162,25 @@ PeleC::read_params()
   pp.query("sum_interval", sum_interval);
   pp.query("dump_old", dump_old);
 
+  ScratchFabPool::setEnabled(use_scratch_pool != 0);
+  ScratchFabPool::setMaxBytes(
+    static_cast<amrex::Long>(scratch_pool_max_mb) * 1024 * 1024);
+
+  // Integrated quantities to report, all of them by default
+  const auto& iq_names = pc_iq_names();
+  amrex::Vector<std::string> sum_quantities(iq_names.begin(), iq_names.end());
+  pp.queryarr("sum_quantities", sum_quantities);
+  sum_iq_list.clear();
+  for (const auto& sq : sum_quantities) {
+    const auto it = std::find(iq_names.begin(), iq_names.end(), sq);
+    if (it == iq_names.end()) {
+      amrex::Abort(
+        "Unknown entry " + sq + " in pelec.sum_quantities, please use: mass, "
+        "xmom, ymom, zmom, rho_e, rho_K, rho_E, enstrophy, fuel_prod, temp");
+    }
+    sum_iq_list.push_back(static_cast<int>(it - iq_names.begin()));
+  }
+
   // Get boundary conditions
   amrex::Vector<std::string> lo_bc_char(AMREX_SPACEDIM);
   amrex::Vector<std::string> hi_bc_char(AMREX_SPACEDIM);
@@ -328,6 +368,14 @@ PeleC::read_params()
   // Read tagging parameters
   read_tagging_params();
 
+  sampling_parm = pc_read_sampling_params();
+
+  perf_log.open(perf_log_file);
+
+  if (incr_check_int > 0 && incr_check_full < 1) {
+    amrex::Abort("pelec.incr_check_full must be at least 1");
+  }
+
   // TODO: What is this?
   amrex::StateDescriptor::setBndryFuncThreadSafety(bndry_func_thread_safe);
 
@@ -338,6 +386,16 @@ PeleC::read_params()
   // whether to gather data
   ppa.query("loadbalance_with_workestimates", do_mol_load_balance);
   ppa.query("loadbalance_with_workestimates", do_react_load_balance);
+
+  if (loadbalance_int > 0) {
+    if (!(do_mol_load_balance || do_react_load_balance)) {
+      amrex::Abort(
+        "pelec.loadbalance_int requires amr.loadbalance_with_workestimates");
+    }
+    if (loadbalance_strategy != "knapsack" && loadbalance_strategy != "sfc") {
+      amrex::Abort("pelec.loadbalance_strategy must be knapsack or sfc");
+    }
+  }
 }
 
 PeleC::PeleC()
@@ -442,6 +500,7 @@ PeleC::PeleC(
 
 #ifdef PELEC_USE_REACTIONS
   get_new_data(Reactions_Type).setVal(0.0);
+  get_new_data(Chem_Dt_Type).setVal(0.0);
 #endif
 
   // Don't need this in pure C++?
@@ -615,6 +674,8 @@ PeleC::initData()
 {
   BL_PROFILE("PeleC::initData()");
 
+  problem_pre_init_data();
+
   // Copy problem parameter structs to device
   amrex::Gpu::copy(
     amrex::Gpu::hostToDevice, PeleC::h_prob_parm_device,
@@ -646,6 +707,7 @@ PeleC::initData()
 
 #ifdef PELEC_USE_REACTIONS
   get_new_data(Reactions_Type).setVal(0.0);
+  get_new_data(Chem_Dt_Type).setVal(0.0);
 #endif
 
   if (do_mol_load_balance || do_react_load_balance) {
@@ -699,6 +761,7 @@ void
 PeleC::init(AmrLevel& old)
 {
   BL_PROFILE("PeleC::init(old)");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Regrid);
 
   auto* oldlev = (PeleC*)&old;
 
@@ -718,8 +781,10 @@ PeleC::init(AmrLevel& old)
   if (do_react) {
     FillPatch(
       old, React_new, 0, cur_time, Reactions_Type, 0, React_new.nComp());
+    FillPatch(old, get_new_data(Chem_Dt_Type), 0, cur_time, Chem_Dt_Type, 0, 1);
   } else {
     React_new.setVal(0);
+    get_new_data(Chem_Dt_Type).setVal(0);
   }
 #endif
 
@@ -737,6 +802,7 @@ PeleC::init()
   // This version inits the data on a new level that did not
   // exist before regridding.
   BL_PROFILE("PeleC::init()");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Regrid);
 
   amrex::Real dt = parent->dtLevel(level);
   amrex::Real cur_time = getLevel(level - 1).state[State_Type].curTime();
@@ -749,6 +815,15 @@ PeleC::init()
   amrex::MultiFab& S_new = get_new_data(State_Type);
   FillCoarsePatch(S_new, 0, cur_time, State_Type, 0, NVAR);
 
+#ifdef PELEC_USE_REACTIONS
+  if (do_react) {
+    FillCoarsePatch(
+      get_new_data(Chem_Dt_Type), 0, cur_time, Chem_Dt_Type, 0, 1);
+  } else {
+    get_new_data(Chem_Dt_Type).setVal(0);
+  }
+#endif
+
   if (do_mol_load_balance || do_react_load_balance) {
     amrex::MultiFab& work_estimate_new = get_new_data(Work_Estimate_Type);
     int ncomp = work_estimate_new.nComp();
@@ -779,6 +854,7 @@ amrex::Real PeleC::estTimeStep(amrex::Real /*dt_old*/)
   BL_PROFILE("PeleC::estTimeStep()");
 
   if (fixed_dt > 0.0) {
+    perf_log.setDtLimiter(level, "pelec.fixed_dt");
     return fixed_dt;
   }
 
@@ -788,8 +864,6 @@ amrex::Real PeleC::estTimeStep(amrex::Real /*dt_old*/)
 
   const amrex::MultiFab& stateMF = get_new_data(State_Type);
 
-  const amrex::Real* dx = geom.CellSize();
-
   std::string limiter = "pelec.max_dt";
 
   // Start the hydro with the max_dt value, but divide by CFL
@@ -798,10 +872,6 @@ amrex::Real PeleC::estTimeStep(amrex::Real /*dt_old*/)
   // criterion, we will get exactly max_dt for a timestep.
 
   const amrex::Real max_dt_over_cfl = max_dt / cfl;
-  amrex::Real estdt_hydro = max_dt_over_cfl;
-  amrex::Real estdt_vdif = max_dt_over_cfl;
-  amrex::Real estdt_tdif = max_dt_over_cfl;
-  amrex::Real estdt_edif = max_dt_over_cfl;
   if (do_hydro || do_mol || diffuse_vel || diffuse_temp || diffuse_enth) {
 
 #ifdef PELEC_USE_EB
@@ -811,126 +881,87 @@ amrex::Real PeleC::estTimeStep(amrex::Real /*dt_old*/)
 #endif
 
     prefetchToDevice(stateMF); // This should accelerate the below operations.
-    amrex::Real AMREX_D_DECL(dx1 = dx[0], dx2 = dx[1], dx3 = dx[2]);
+    const auto dxa = geom.CellSizeArray();
+    const bool l_do_hydro = do_hydro != 0;
+    const bool l_diffuse_vel = diffuse_vel != 0;
+    const bool l_diffuse_temp = diffuse_temp != 0;
+    const bool l_diffuse_enth = diffuse_enth != 0;
+    pele::physics::transport::TransParm const* ltransparm =
+      pele::physics::transport::trans_parm_g;
+
+    // All the constraints are reduced in a single sweep so that the EOS and
+    // transport coefficients are evaluated once per cell
+    amrex::ReduceOps<
+      amrex::ReduceOpMin, amrex::ReduceOpMin, amrex::ReduceOpMin,
+      amrex::ReduceOpMin>
+      reduce_op;
+    amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real>
+      reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
 
-    if (do_hydro) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_hydro(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
-#endif
-            AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_hydro = amrex::min<amrex::Real>(estdt_hydro, dt);
-    }
-
-    if (diffuse_vel) {
-      pele::physics::transport::TransParm const* ltransparm =
-        pele::physics::transport::trans_parm_g;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_veldif(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-            AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
-        });
-      estdt_vdif = amrex::min<amrex::Real>(estdt_vdif, dt);
-    }
-
-    if (diffuse_temp) {
-      pele::physics::transport::TransParm const* ltransparm =
-        pele::physics::transport::trans_parm_g;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
+    for (amrex::MFIter mfi(stateMF, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      const amrex::Box& bx = mfi.tilebox();
+      auto const& u = stateMF.const_array(mfi);
 #ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
+      auto const& flag_arr = flags.const_array(mfi);
+#endif
+      reduce_op.eval(
+        bx, reduce_data,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+          amrex::Real dt[ESTDT_NUM] = {
+            max_dt_over_cfl, max_dt_over_cfl, max_dt_over_cfl,
+            max_dt_over_cfl};
 #ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
+          if (!flag_arr(i, j, k).isCovered()) {
 #endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_tempdif(
-            bx, fab_arr,
+            pc_estdt(
+              i, j, k, u, dxa, l_do_hydro, l_diffuse_vel, l_diffuse_temp,
+              l_diffuse_enth, ltransparm, dt);
 #ifdef PELEC_USE_EB
-            flag_arr,
+          }
 #endif
-            AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
+          return {
+            dt[ESTDT_HYDRO], dt[ESTDT_VELDIF], dt[ESTDT_TEMPDIF],
+            dt[ESTDT_ENTHDIF]};
         });
-      estdt_tdif = amrex::min<amrex::Real>(estdt_tdif, dt);
     }
 
-    if (diffuse_enth) {
-      pele::physics::transport::TransParm const* ltransparm =
-        pele::physics::transport::trans_parm_g;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_enthdif(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
-#endif
-            AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
-        });
-      estdt_edif = amrex::min<amrex::Real>(estdt_edif, dt);
+    const ReduceTuple hv = reduce_data.value(reduce_op);
+    amrex::Real estdt_c[ESTDT_NUM] = {
+      amrex::get<0>(hv), amrex::get<1>(hv), amrex::get<2>(hv),
+      amrex::get<3>(hv)};
+    amrex::ParallelDescriptor::ReduceRealMin(estdt_c, ESTDT_NUM);
+
+    const char* constraint_names[ESTDT_NUM] = {
+      "hydro", "diffuse_vel", "diffuse_temp", "diffuse_enth"};
+    int limiting = ESTDT_HYDRO;
+    for (int n = 0; n < ESTDT_NUM; n++) {
+      estdt_c[n] *= cfl;
+      if (estdt_c[n] < estdt_c[limiting]) {
+        limiting = n;
+      }
     }
-
-    estdt_hydro = amrex::min<amrex::Real>(
-      estdt_hydro,
-      amrex::min<amrex::Real>(
-        estdt_vdif, amrex::min<amrex::Real>(estdt_tdif, estdt_edif)));
-
-    amrex::ParallelDescriptor::ReduceRealMin(estdt_hydro);
-    estdt_hydro *= cfl;
+    const amrex::Real estdt_hydro = estdt_c[limiting];
 
     if (verbose) {
       amrex::Print() << "...estimated hydro-limited timestep at level " << level
-                     << ": " << estdt_hydro << std::endl;
+                     << ": " << estdt_hydro << " ("
+                     << constraint_names[limiting] << ")" << std::endl;
+    }
+    if (verbose > 1) {
+      for (int n = 0; n < ESTDT_NUM; n++) {
+        amrex::Print() << "......" << constraint_names[n] << ": " << estdt_c[n]
+                       << std::endl;
+      }
     }
 
     // Determine if this is more restrictive than the maximum timestep limiting
     if (estdt_hydro < estdt) {
-      limiter = "hydro";
+      limiter = constraint_names[limiting];
       estdt = estdt_hydro;
     }
   }
@@ -950,6 +981,7 @@ amrex::Real PeleC::estTimeStep(amrex::Real /*dt_old*/)
     amrex::Print() << "PeleC::estTimeStep (" << limiter << "-limited) at level "
                    << level << ":  estdt = " << estdt << '\n';
   }
+  perf_log.setDtLimiter(level, limiter);
 
   return estdt;
 }
@@ -1122,6 +1154,23 @@ PeleC::post_timestep(int
 
   problem_post_timestep();
 
+  // Flag this level for a remap if its work is badly spread over the ranks
+  if (
+    loadbalance_int > 0 && parent->levelSteps(0) % loadbalance_int == 0 &&
+    amrex::ParallelDescriptor::NProcs() > 1) {
+    const amrex::Real imbalance = workImbalance();
+    if (verbose > 0) {
+      amrex::Print() << "Level " << level << " work imbalance (max/mean) = "
+                     << imbalance << std::endl;
+    }
+    if (
+      imbalance > loadbalance_threshold &&
+      std::find(rebalance_levels.begin(), rebalance_levels.end(), level) ==
+        rebalance_levels.end()) {
+      rebalance_levels.push_back(level);
+    }
+  }
+
   if (level == 0) {
     int nstep = parent->levelSteps(0);
     amrex::Real dtlev = parent->dtLevel(0);
@@ -1145,6 +1194,10 @@ PeleC::post_timestep(int
     if (sum_int_test || sum_per_test) {
       sum_integrated_quantities();
     }
+
+    if (sampling_parm.interval > 0 && nstep % sampling_parm.interval == 0) {
+      write_samples();
+    }
   }
 }
 
@@ -1174,6 +1227,10 @@ PeleC::post_restart()
   //  init_godunov_indices();
   //}
 
+  if (!restart_delta.empty()) {
+    restartFromDelta();
+  }
+
   // initialize LES variables
   if (do_les) {
     init_les();
@@ -1193,6 +1250,29 @@ PeleC::postCoarseTimeStep(amrex::Real cumtime)
 {
   BL_PROFILE("PeleC::postCoarseTimeStep()");
   AmrLevel::postCoarseTimeStep(cumtime);
+
+  if (verbose > 1 && ScratchFabPool::active()) {
+    for (int lev = 0; lev <= parent->finestLevel(); lev++) {
+      getLevel(lev).scratch_pool.printStats("Level " + std::to_string(lev));
+    }
+  }
+
+  if (incr_check_int > 0 && parent->levelSteps(0) % incr_check_int == 0) {
+    incrementalCheckPoint();
+  }
+
+  if (perf_log.active()) {
+    const int nlevs = parent->finestLevel() + 1;
+    amrex::Vector<amrex::Real> dts(nlevs);
+    amrex::Vector<amrex::Long> cells(nlevs);
+    amrex::Vector<int> ngrids(nlevs);
+    for (int lev = 0; lev < nlevs; lev++) {
+      dts[lev] = parent->dtLevel(lev);
+      cells[lev] = parent->boxArray(lev).numPts();
+      ngrids[lev] = parent->boxArray(lev).size();
+    }
+    perf_log.write(parent->levelSteps(0), cumtime, dts, cells, ngrids);
+  }
 }
 
 void
@@ -1205,8 +1285,14 @@ PeleC::post_regrid(
   int /*new_finest*/)
 {
   BL_PROFILE("PeleC::post_regrid()");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Regrid);
   fine_mask.clear();
 
+  // Regridded levels were distributed by Amr from their work estimates
+  rebalance_levels.erase(
+    std::remove(rebalance_levels.begin(), rebalance_levels.end(), level),
+    rebalance_levels.end());
+
 #ifdef AMREX_PARTICLES
   if (do_spray_particles && theSprayPC() != 0 && level == lbase) {
     // TODO: Determine how many ghost cells to use here
@@ -1216,6 +1302,114 @@ PeleC::post_regrid(
 #endif
 }
 
+void
+PeleC::add_work_estimate(
+  const amrex::MFIter& mfi, const amrex::Box& bx, amrex::Real t0)
+{
+#ifdef AMREX_USE_GPU
+  // The kernels of the tile may still be running, give its cells a fixed cost
+  amrex::ignore_unused(t0);
+  const amrex::Real wt = gpu_work_cell_cost;
+#else
+  const amrex::Real wt =
+    (amrex::ParallelDescriptor::second() - t0) / bx.d_numPts();
+#endif
+  get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(wt, bx);
+}
+
+void
+PeleC::add_react_work_estimate(
+  const amrex::MFIter& mfi,
+  const amrex::Box& bx,
+  amrex::Real t0,
+  const amrex::Array4<const int>& mask)
+{
+#ifdef AMREX_USE_GPU
+  // The cost of a reacting cell follows its RHS evaluations, which the
+  // integrator left in fctCount
+  amrex::ignore_unused(t0);
+  const amrex::Real rhs_cost = gpu_work_rhs_cost;
+  auto const& fc = fctCount.const_array(mfi);
+  auto const& work = get_new_data(Work_Estimate_Type).array(mfi);
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    if (mask(i, j, k) != 0) {
+      work(i, j, k) += rhs_cost * fc(i, j, k);
+    }
+  });
+#else
+  amrex::ignore_unused(mask);
+  add_work_estimate(mfi, bx, t0);
+#endif
+}
+
+void
+PeleC::scale_work_estimate(amrex::Real elapsed)
+{
+  amrex::MultiFab& work = get_new_data(Work_Estimate_Type);
+  const bool local = true;
+  const amrex::Real sum = work.sum(0, local);
+  if (sum > 0.0) {
+    work.mult(elapsed / sum);
+  }
+}
+
+amrex::Real
+PeleC::workImbalance()
+{
+  BL_PROFILE("PeleC::workImbalance()");
+
+  const bool local = true;
+  amrex::Real cost_max = get_new_data(Work_Estimate_Type).sum(0, local);
+  amrex::Real cost_sum = cost_max;
+  amrex::ParallelDescriptor::ReduceRealMax(cost_max);
+  amrex::ParallelDescriptor::ReduceRealSum(cost_sum);
+  const amrex::Real mean = cost_sum / amrex::ParallelDescriptor::NProcs();
+  return mean > 0.0 ? cost_max / mean : 1.0;
+}
+
+void
+PeleC::rebalanceLevels(amrex::Amr& amr)
+{
+  if (rebalance_levels.empty()) {
+    return;
+  }
+  amrex::Vector<int> levels;
+  std::swap(levels, rebalance_levels);
+  std::sort(levels.begin(), levels.end());
+  for (const int lev : levels) {
+    rebalanceLevel(amr, lev);
+  }
+}
+
+void
+PeleC::rebalanceLevel(amrex::Amr& amr, int lev)
+{
+  BL_PROFILE("PeleC::rebalanceLevel()");
+
+  const amrex::MultiFab& work =
+    amr.getLevel(lev).get_new_data(Work_Estimate_Type);
+  const amrex::DistributionMapping dm =
+    loadbalance_strategy == "sfc"
+      ? amrex::DistributionMapping::makeSFC(work)
+      : amrex::DistributionMapping::makeKnapSack(work);
+
+  if (verbose > 0) {
+    amrex::Print() << "Remapping level " << lev << " with "
+                   << loadbalance_strategy << std::endl;
+  }
+
+  amr.InstallNewDistributionMap(lev, dm);
+
+  // The flux registers of the next finer level refer to the old mapping of
+  // this level, rebuild that level on its own mapping to redefine them
+  if (do_reflux && lev < amr.finestLevel()) {
+    const amrex::DistributionMapping fine_dm = amr.DistributionMap(lev + 1);
+    amr.InstallNewDistributionMap(lev + 1, fine_dm);
+  }
+
+  amr.getLevel(lev).post_regrid(lev, amr.finestLevel());
+}
+
 void PeleC::post_init(amrex::Real /*stop_time*/)
 {
   BL_PROFILE("PeleC::post_init()");
@@ -1276,6 +1470,10 @@ void PeleC::post_init(amrex::Real /*stop_time*/)
   if (sum_int_test || sum_per_test) {
     sum_integrated_quantities();
   }
+
+  if (sampling_parm.interval > 0 && nstep % sampling_parm.interval == 0) {
+    write_samples();
+  }
 }
 
 int
@@ -1307,6 +1505,7 @@ void
 PeleC::reflux()
 {
   BL_PROFILE("PeleC::reflux()");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Reflux);
 
   AMREX_ASSERT(level < parent->finestLevel());
 
@@ -1544,243 +1743,71 @@ PeleC::errorEst(
   int /*ngrow*/)
 {
   BL_PROFILE("PeleC::errorEst()");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Regrid);
+
+  const amrex::Vector<TagCriterion> crit =
+    tagging_parm->levelCriteria(level, time);
+  constexpr bool prob_tags =
+    !std::is_same<ProblemTags, EmptyProbTagStruct>::value;
+  if (crit.empty() && !prob_tags) {
+    return;
+  }
 
+  // Fill only the ghost cells the criteria need, problem tags may use two
+  int ngrow = prob_tags ? 2 : 0;
+  bool need_state = prob_tags;
+  for (const auto& c : crit) {
+    ngrow = amrex::max(ngrow, tag_criterion_ngrow(c));
+    need_state = need_state || c.quantity != TAG_VFRAC;
+  }
   amrex::MultiFab S_data(
     get_new_data(State_Type).boxArray(),
-    get_new_data(State_Type).DistributionMap(), NVAR, 2);
-  const amrex::Real cur_time = state[State_Type].curTime();
-  FillPatch(
-    *this, S_data, S_data.nGrow(), cur_time, State_Type, Density, NVAR, 0);
+    get_new_data(State_Type).DistributionMap(), need_state ? NVAR : 1, ngrow);
+  if (need_state) {
+    const amrex::Real cur_time = state[State_Type].curTime();
+    FillPatch(
+      *this, S_data, S_data.nGrow(), cur_time, State_Type, Density, NVAR, 0);
+  }
+
+  const int ncrit = crit.size();
+  amrex::Gpu::DeviceVector<TagCriterion> d_crit(ncrit);
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, crit.begin(), crit.end(), d_crit.begin());
+  const TagCriterion* crit_ptr = d_crit.data();
 
-  amrex::Vector<amrex::BCRec> bcs(NVAR);
   const char tagval = amrex::TagBox::SET;
-  // const char clearval = amrex::TagBox::CLEAR;
+  const ProbParmDevice* lprobparm = d_prob_parm_device;
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo =
+    geom.ProbLoArray();
+  const auto captured_level = level;
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-  {
-    for (amrex::MFIter mfi(S_data, amrex::TilingIfNotGPU()); mfi.isValid();
-         ++mfi) {
-      const amrex::Box& tilebox = mfi.tilebox();
-      const auto Sfab = S_data.array(mfi);
-      auto tag_arr = tags.array(mfi);
-      const auto datbox = S_data[mfi].box();
-      amrex::Elixir S_data_mfi_eli = S_data[mfi].elixir();
-
-#ifdef PELEC_USE_EB
-      const auto vfrac_arr = vfrac.array(mfi);
-#endif
-
-      amrex::FArrayBox S_derData(datbox, 1);
-      amrex::Elixir S_derData_eli = S_derData.elixir();
-      auto S_derarr = S_derData.array();
-      const int ncp = S_derData.nComp();
-      const int* bc = bcs[0].data();
-
-      // Tagging density
-      if (level < tagging_parm->max_denerr_lev) {
-        const amrex::Real captured_denerr = tagging_parm->denerr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, Sfab, captured_denerr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_dengrad_lev) {
-        const amrex::Real captured_dengrad = tagging_parm->dengrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(i, j, k, tag_arr, Sfab, captured_dengrad, tagval);
-          });
-      }
-
-      // Tagging pressure
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_derpres(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_presserr_lev) {
-        const amrex::Real captured_presserr = tagging_parm->presserr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, captured_presserr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_pressgrad_lev) {
-        const amrex::Real captured_pressgrad = tagging_parm->pressgrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, captured_pressgrad, tagval);
-          });
-      }
-
-      // Tagging vel_x
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervelx(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_velerr_lev) {
-        const amrex::Real captured_velerr = tagging_parm->velerr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_abserror(i, j, k, tag_arr, S_derarr, captured_velerr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_velgrad_lev) {
-        const amrex::Real captured_velgrad = tagging_parm->velgrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(i, j, k, tag_arr, S_derarr, captured_velgrad, tagval);
-          });
-      }
-
-      // Tagging vel_y
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervely(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_velerr_lev) {
-        const amrex::Real captured_velerr = tagging_parm->velerr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_abserror(i, j, k, tag_arr, S_derarr, captured_velerr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_velgrad_lev) {
-        const amrex::Real captured_velgrad = tagging_parm->velgrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(i, j, k, tag_arr, S_derarr, captured_velgrad, tagval);
-          });
-      }
-
-      // Tagging vel_z
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervelz(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_velerr_lev) {
-        const amrex::Real captured_velerr = tagging_parm->velerr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_abserror(i, j, k, tag_arr, S_derarr, captured_velerr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_velgrad_lev) {
-        const amrex::Real captured_velgrad = tagging_parm->velgrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(i, j, k, tag_arr, S_derarr, captured_velgrad, tagval);
-          });
-      }
-
-      // Tagging magnitude of vorticity
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dermagvort(
-        tilebox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_vorterr_lev) {
-        const amrex::Real vorterr =
-          tagging_parm->vorterr * std::pow(2.0, level);
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_abserror(i, j, k, tag_arr, S_derarr, vorterr, tagval);
-          });
-      }
-
-      // Tagging temperature
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dertemp(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < tagging_parm->max_temperr_lev) {
-        const amrex::Real captured_temperr = tagging_parm->temperr;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, captured_temperr, tagval);
-          });
-      }
-      if (level < tagging_parm->max_tempgrad_lev) {
-        const amrex::Real captured_tempgrad = tagging_parm->tempgrad;
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, captured_tempgrad, tagval);
-          });
-      }
-
-      // Tagging flame tracer
-      if (!flame_trac_name.empty()) {
-        int idx = -1;
-        for (int i = 0; i < spec_names.size(); ++i) {
-          if (flame_trac_name == spec_names[i]) {
-            idx = i;
-          }
-        }
-
-        if (idx >= 0) {
-          // const std::string name = "Y("+flame_trac_name+")";
-          // if (amrex::ParallelDescriptor::IOProcessor())
-          // amrex::Print() << " Flame tracer will be " << name << '\n';
-
-          S_derData.setVal<amrex::RunOn::Device>(0.0);
-          pc_derspectrac(
-            datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-            level, idx);
-
-          if (level < tagging_parm->max_ftracerr_lev) {
-            const amrex::Real captured_ftracerr = tagging_parm->ftracerr;
-            amrex::ParallelFor(
-              tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tag_error(
-                  i, j, k, tag_arr, S_derarr, captured_ftracerr, tagval);
-              });
-          }
-          if (level < tagging_parm->max_ftracgrad_lev) {
-            const amrex::Real captured_ftracgrad = tagging_parm->ftracgrad;
-            amrex::ParallelFor(
-              tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tag_graderror(
-                  i, j, k, tag_arr, S_derarr, captured_ftracgrad, tagval);
-              });
-          }
-
-        } else {
-          amrex::Abort("Unknown species identified as flame_trac_name");
-        }
-      }
-
+  for (amrex::MFIter mfi(S_data, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    const amrex::Box& tilebox = mfi.tilebox();
+    const auto Sfab = S_data.const_array(mfi);
+    auto tag_arr = tags.array(mfi);
 #ifdef PELEC_USE_EB
-      // Tagging volume fraction
-      if (level < tagging_parm->max_vfracerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error_bounds(i, j, k, tag_arr, vfrac_arr, 0.0, 1.0, tagval);
-          });
-      }
+    const auto vfrac_arr = vfrac.const_array(mfi);
+#else
+    const amrex::Array4<const amrex::Real> vfrac_arr;
 #endif
 
-      // Problem specific tagging
-      const ProbParmDevice* lprobparm = d_prob_parm_device;
-      const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx =
-        geom.CellSizeArray();
-      const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo =
-        geom.ProbLoArray();
-      const auto captured_level = level;
-      amrex::ParallelFor(
-        tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-          set_problem_tags<ProblemTags>(
-            i, j, k, tag_arr, Sfab, tagval, dx, prob_lo, time, captured_level,
-            *lprobparm);
-        });
-
-      // Now update the tags in the TagBox.
-      // tag_arr.tags(itags, tilebox);
-      // rho_eli.clear();
-      // temp_eli.clear();
-    }
+    // All the criteria and the problem specific tagging in one pass
+    amrex::ParallelFor(
+      tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        pc_tag_cell(
+          i, j, k, tag_arr, Sfab, vfrac_arr, crit_ptr, ncrit, dx, prob_lo,
+          tagval);
+        set_problem_tags<ProblemTags>(
+          i, j, k, tag_arr, Sfab, tagval, dx, prob_lo, time, captured_level,
+          *lprobparm);
+      });
   }
+  amrex::Gpu::streamSynchronize();
 }
 
 std::unique_ptr<amrex::MultiFab>
@@ -1864,11 +1891,31 @@ PeleC::init_reactor()
     reactor_init(1, 1);
   }
 #endif
+
+  if (use_isat != 0) {
+#ifdef AMREX_USE_GPU
+    amrex::Abort("use_isat is not supported on GPU");
+#endif
+    if (chem_integrator != 1) {
+      amrex::Abort("use_isat requires chem_integrator = 1");
+    }
+    // Key: Y, ln(T), ln(rho), ln(dt) and the scaled external sources,
+    // value: the chemical mass fraction increments
+    isat_table = std::make_unique<ISATTable>(
+      pc_isat_nin, NUM_SPECIES, isat_tol,
+      static_cast<amrex::Long>(isat_max_mb * 1024 * 1024));
+  }
 }
 
 void
 PeleC::close_reactor()
 {
+  if (isat_table != nullptr) {
+    if (verbose > 0) {
+      isat_table->printStats();
+    }
+    isat_table.reset();
+  }
 }
 #endif
 
@@ -1882,10 +1929,19 @@ PeleC::init_les()
   LES_Coeffs.setVal(CI, comp_CI, 1, LES_Coeffs.nGrow());
   if (les_model == 1) {
     LES_Coeffs.setVal(Cs * Cs * PrT, comp_Cs2ovPrT, 1, LES_Coeffs.nGrow());
+    les_test_filter = Filter(les_test_filter_type, les_test_filter_fgr);
+    les_coeff_filter = Filter(box, 6);
   } else {
     LES_Coeffs.setVal(PrT, comp_PrT, 1, LES_Coeffs.nGrow());
   }
 
+  // The LES reads the state filled in Sborder by the advance
+  if (Sborder.empty() || Sborder.nGrow() < nGrowLES()) {
+    Sborder.define(
+      grids, dmap, NVAR, std::max(Sborder.nGrow(), nGrowLES()),
+      amrex::MFInfo(), Factory());
+  }
+
   amrex::Print() << "WARNING: LES with Fuego assumes Cp is a weak function of T"
                  << std::endl;
   if (NUM_SPECIES > 2) {
@@ -1917,7 +1973,8 @@ PeleC::init_filters()
   // Add grow cells necessary for explicit filtering of source terms
   if (do_hydro) {
     Sborder.define(
-      grids, dmap, NVAR, Sborder.nGrow() + nGrowF, amrex::MFInfo(), Factory());
+      grids, dmap, NVAR, std::max(Sborder.nGrow(), numGrow() + nGrowF),
+      amrex::MFInfo(), Factory());
     hydro_source.define(
       grids, dmap, NVAR, hydro_source.nGrow() + nGrowF, amrex::MFInfo(),
       Factory());
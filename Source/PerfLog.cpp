@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <iomanip>
+#include <sys/resource.h>
+
+#include <AMReX.H>
+#include <AMReX_BaseFab.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include "PerfLog.H"
+
+namespace {
+const char* phase_names[PerfLog::NumPhases] = {
+  "hydro", "diffusion", "reactions", "fillpatch", "reflux", "regrid"};
+
+// Peak resident set size of this process in bytes
+amrex::Long
+peak_rss()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return static_cast<amrex::Long>(usage.ru_maxrss) * 1024;
+#endif
+}
+} // namespace
+
+void
+PerfLog::open(const std::string& file)
+{
+  m_active = !file.empty();
+  m_step_start = amrex::ParallelDescriptor::second();
+  if (m_active && amrex::ParallelDescriptor::IOProcessor()) {
+    m_file.open(file, std::ios::out | std::ios::app);
+    if (!m_file.good()) {
+      amrex::Abort("Unable to open perf_log_file " + file);
+    }
+  }
+}
+
+PerfLog::Level&
+PerfLog::level(int lev)
+{
+  if (lev >= static_cast<int>(m_levels.size())) {
+    m_levels.resize(lev + 1);
+  }
+  return m_levels[lev];
+}
+
+void
+PerfLog::addTime(int lev, int phase, amrex::Real t)
+{
+  level(lev).time[phase] += t;
+}
+
+void
+PerfLog::addChemistry(
+  int lev, amrex::Long cells, amrex::Long substeps, amrex::Long max_substeps)
+{
+  Level& l = level(lev);
+  l.chem_cells += cells;
+  l.chem_substeps += substeps;
+  l.chem_max_substeps = std::max(l.chem_max_substeps, max_substeps);
+}
+
+void
+PerfLog::setDtLimiter(int lev, const std::string& limiter)
+{
+  level(lev).dt_limiter = limiter;
+}
+
+void
+PerfLog::write(
+  int step,
+  amrex::Real time,
+  const amrex::Vector<amrex::Real>& dt,
+  const amrex::Vector<amrex::Long>& cells,
+  const amrex::Vector<int>& grids)
+{
+  if (!m_active) {
+    return;
+  }
+  const int nlevs = cells.size();
+  level(nlevs - 1);
+
+  // One reduction each for the maxima and the sums
+  amrex::Vector<amrex::Real> rmax(nlevs * NumPhases + 1);
+  amrex::Vector<amrex::Long> lmax(nlevs + 2);
+  amrex::Vector<amrex::Long> lsum(2 * nlevs);
+  for (int lev = 0; lev < nlevs; lev++) {
+    for (int n = 0; n < NumPhases; n++) {
+      rmax[lev * NumPhases + n] = m_levels[lev].time[n];
+    }
+    lmax[lev] = m_levels[lev].chem_max_substeps;
+    lsum[2 * lev] = m_levels[lev].chem_cells;
+    lsum[2 * lev + 1] = m_levels[lev].chem_substeps;
+  }
+  rmax[nlevs * NumPhases] = amrex::ParallelDescriptor::second() - m_step_start;
+  lmax[nlevs] = peak_rss();
+  lmax[nlevs + 1] = amrex::TotalBytesAllocatedInFabsHWM();
+  const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
+  amrex::ParallelDescriptor::ReduceRealMax(rmax.data(), rmax.size(), IOProc);
+  amrex::ParallelDescriptor::ReduceLongMax(lmax.data(), lmax.size(), IOProc);
+  amrex::ParallelDescriptor::ReduceLongSum(lsum.data(), lsum.size(), IOProc);
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    m_file << std::setprecision(10);
+    for (int lev = 0; lev < nlevs; lev++) {
+      m_file << "{\"step\":" << step << ",\"time\":" << time
+             << ",\"level\":" << lev << ",\"dt\":" << dt[lev]
+             << ",\"cells\":" << cells[lev] << ",\"grids\":" << grids[lev]
+             << ",\"ranks\":" << amrex::ParallelDescriptor::NProcs()
+             << ",\"step_wall\":" << rmax[nlevs * NumPhases] << ",\"wall\":{";
+      for (int n = 0; n < NumPhases; n++) {
+        m_file << (n > 0 ? "," : "") << "\"" << phase_names[n]
+               << "\":" << rmax[lev * NumPhases + n];
+      }
+      const amrex::Long chem_cells = lsum[2 * lev];
+      const amrex::Long chem_substeps = lsum[2 * lev + 1];
+      m_file << "},\"chemistry\":{\"cells\":" << chem_cells
+             << ",\"substeps\":" << chem_substeps << ",\"mean_substeps\":"
+             << (chem_cells > 0 ? static_cast<amrex::Real>(chem_substeps) /
+                                    static_cast<amrex::Real>(chem_cells)
+                                : 0.0)
+             << ",\"max_substeps\":" << lmax[lev] << "},\"dt_limiter\":\""
+             << m_levels[lev].dt_limiter << "\",\"peak_rss_bytes\":"
+             << lmax[nlevs] << ",\"fab_hwm_bytes\":" << lmax[nlevs + 1]
+             << "}\n";
+    }
+    m_file.flush();
+  }
+
+  for (auto& l : m_levels) {
+    l = Level();
+  }
+  m_step_start = amrex::ParallelDescriptor::second();
+}
+
+PerfLogTimer::PerfLogTimer(PerfLog& log, int lev, int phase)
+  : m_log(log), m_lev(lev), m_phase(phase)
+{
+  if (m_log.active()) {
+    m_t0 = amrex::ParallelDescriptor::second();
+  }
+}
+
+PerfLogTimer::~PerfLogTimer()
+{
+  if (m_log.active()) {
+    // Charge the kernels launched in the scope to it
+    amrex::Gpu::streamSynchronize();
+    m_log.addTime(m_lev, m_phase, amrex::ParallelDescriptor::second() - m_t0);
+  }
+}
@@ -0,0 +1,293 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include "PlotCompress.H"
+
+namespace {
+
+enum CompMode : std::uint8_t { CompRaw = 0, CompQuantized = 1 };
+
+// Largest quantized magnitude, leaving room for the differences
+constexpr double max_quant = 4.0e18;
+
+void
+put_bytes(std::vector<char>& out, const void* p, const std::size_t n)
+{
+  const char* c = static_cast<const char*>(p);
+  out.insert(out.end(), c, c + n);
+}
+
+void
+put_varint(std::vector<char>& out, std::uint64_t u)
+{
+  while (u >= 0x80) {
+    out.push_back(static_cast<char>((u & 0x7f) | 0x80));
+    u >>= 7;
+  }
+  out.push_back(static_cast<char>(u));
+}
+
+std::uint64_t
+get_varint(const char*& p)
+{
+  std::uint64_t u = 0;
+  int shift = 0;
+  std::uint8_t b = 0;
+  do {
+    b = static_cast<std::uint8_t>(*p++);
+    u |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+    shift += 7;
+  } while ((b & 0x80) != 0);
+  return u;
+}
+
+// Append component n of fab on bx: mode, step, byte count and bytes
+void
+encode_comp(
+  const amrex::FArrayBox& fab,
+  const amrex::Box& bx,
+  const int n,
+  const amrex::Real tol,
+  const bool rel,
+  std::vector<char>& out)
+{
+  const auto a = fab.const_array();
+  const amrex::Long npts = bx.numPts();
+  const auto lo = amrex::lbound(bx);
+  const auto len = amrex::length(bx);
+  const amrex::Long nxy = static_cast<amrex::Long>(len.x) * len.y;
+  auto value = [&](const amrex::Long m) {
+    const int i = static_cast<int>(m % len.x);
+    const int j = static_cast<int>((m / len.x) % len.y);
+    const int k = static_cast<int>(m / nxy);
+    return static_cast<double>(a(lo.x + i, lo.y + j, lo.z + k, n));
+  };
+
+  double vmax = 0.0;
+  bool finite = true;
+  for (amrex::Long m = 0; m < npts; m++) {
+    const double v = value(m);
+    finite = finite && std::isfinite(v);
+    vmax = amrex::max(vmax, std::abs(v));
+  }
+  double step = 2.0 * (rel ? tol * vmax : tol);
+  std::uint8_t mode = CompQuantized;
+  if (!finite || !(step > 0.0) || vmax / step > max_quant) {
+    mode = CompRaw;
+    step = 0.0;
+  }
+
+  std::vector<char> bytes;
+  if (mode == CompRaw) {
+    bytes.resize(npts * sizeof(double));
+    for (amrex::Long m = 0; m < npts; m++) {
+      const double v = value(m);
+      std::memcpy(&bytes[m * sizeof(double)], &v, sizeof(double));
+    }
+  } else {
+    bytes.reserve(npts);
+    std::int64_t prev = 0;
+    for (amrex::Long m = 0; m < npts; m++) {
+      const auto q = static_cast<std::int64_t>(std::llround(value(m) / step));
+      const std::int64_t d = q - prev;
+      prev = q;
+      put_varint(
+        bytes, (static_cast<std::uint64_t>(d) << 1) ^
+                 static_cast<std::uint64_t>(d >> 63));
+    }
+  }
+
+  const std::uint64_t nbytes = bytes.size();
+  put_bytes(out, &mode, sizeof(mode));
+  put_bytes(out, &step, sizeof(step));
+  put_bytes(out, &nbytes, sizeof(nbytes));
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+// Decode component n of fab on bx from p, advancing p past it
+void
+decode_comp(
+  const char*& p, amrex::FArrayBox& fab, const amrex::Box& bx, const int n)
+{
+  std::uint8_t mode;
+  double step;
+  std::uint64_t nbytes;
+  std::memcpy(&mode, p, sizeof(mode));
+  p += sizeof(mode);
+  std::memcpy(&step, p, sizeof(step));
+  p += sizeof(step);
+  std::memcpy(&nbytes, p, sizeof(nbytes));
+  p += sizeof(nbytes);
+  const char* end = p + nbytes;
+
+  const auto a = fab.array();
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+  std::int64_t q = 0;
+  for (int k = lo.z; k <= hi.z; k++) {
+    for (int j = lo.y; j <= hi.y; j++) {
+      for (int i = lo.x; i <= hi.x; i++) {
+        double v;
+        if (mode == CompRaw) {
+          std::memcpy(&v, p, sizeof(double));
+          p += sizeof(double);
+        } else {
+          const std::uint64_t u = get_varint(p);
+          q += static_cast<std::int64_t>(u >> 1) ^
+               -static_cast<std::int64_t>(u & 1);
+          v = q * step;
+        }
+        a(i, j, k, n) = v;
+      }
+    }
+  }
+  AMREX_ALWAYS_ASSERT(p == end);
+}
+
+std::string
+data_file_name(const std::string& path, const int rank)
+{
+  return amrex::Concatenate(path + "_Z_D_", rank, 5);
+}
+
+} // namespace
+
+void
+pc_write_compressed_mf(
+  const amrex::MultiFab& mf,
+  const std::string& path,
+  const amrex::Vector<amrex::Real>& tol,
+  const amrex::Vector<int>& rel)
+{
+  BL_PROFILE("pc_write_compressed_mf()");
+
+  const int ncomp = mf.nComp();
+  AMREX_ALWAYS_ASSERT(tol.size() == ncomp && rel.size() == ncomp);
+  const amrex::BoxArray& ba = mf.boxArray();
+  const int nboxes = ba.size();
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+
+  // Encode the local FABs into this rank's data file
+  amrex::Vector<amrex::Long> offsets(nboxes, 0);
+  amrex::Long bytes_written = 0;
+  if (mf.local_size() > 0) {
+    std::ofstream ofs(data_file_name(path, myproc), std::ios::binary);
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(data_file_name(path, myproc));
+    }
+    std::vector<char> out;
+    for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+      const amrex::Box& bx = mfi.validbox();
+      amrex::FArrayBox hfab(bx, ncomp, amrex::The_Pinned_Arena());
+      hfab.copy<amrex::RunOn::Device>(mf[mfi], bx);
+      amrex::Gpu::streamSynchronize();
+
+      out.clear();
+      for (int n = 0; n < ncomp; n++) {
+        encode_comp(hfab, bx, n, tol[n], rel[n] != 0, out);
+      }
+      offsets[mfi.index()] = bytes_written;
+      ofs.write(out.data(), out.size());
+      bytes_written += out.size();
+    }
+  }
+
+  amrex::ParallelDescriptor::ReduceLongSum(
+    offsets.dataPtr(), nboxes, amrex::ParallelDescriptor::IOProcessorNumber());
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    const std::string hname = path + "_Z_H";
+    std::ofstream ofs(hname);
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(hname);
+    }
+    ofs.precision(17);
+    ofs << PC_PLOT_CODEC << '\n' << ncomp << '\n';
+    for (int n = 0; n < ncomp; n++) {
+      ofs << tol[n] << ' ' << rel[n] << '\n';
+    }
+    ba.writeOn(ofs);
+    ofs << '\n';
+    const amrex::DistributionMapping& dm = mf.DistributionMap();
+    for (int i = 0; i < nboxes; i++) {
+      const std::string dname = data_file_name(path, dm[i]);
+      ofs << dname.substr(dname.find_last_of('/') + 1) << ' ' << offsets[i]
+          << '\n';
+    }
+  }
+}
+
+void
+pc_read_compressed_mf(amrex::MultiFab& mf, const std::string& path)
+{
+  BL_PROFILE("pc_read_compressed_mf()");
+
+  const std::string hname = path + "_Z_H";
+  std::ifstream ifs(hname);
+  if (!ifs.good()) {
+    amrex::FileOpenFailed(hname);
+  }
+  std::string codec;
+  ifs >> codec;
+  if (codec != PC_PLOT_CODEC) {
+    amrex::Abort("Unknown plotfile codec " + codec + " in " + hname);
+  }
+  int ncomp = 0;
+  ifs >> ncomp;
+  for (int n = 0; n < ncomp; n++) {
+    amrex::Real tol;
+    int rel;
+    ifs >> tol >> rel;
+  }
+  amrex::BoxArray ba;
+  ba.readFrom(ifs);
+  const int nboxes = ba.size();
+  amrex::Vector<std::string> files(nboxes);
+  amrex::Vector<amrex::Long> offsets(nboxes);
+  for (int i = 0; i < nboxes; i++) {
+    ifs >> files[i] >> offsets[i];
+  }
+
+  const std::string dir = path.substr(0, path.find_last_of('/') + 1);
+  amrex::DistributionMapping dm(ba);
+  mf.define(ba, dm, ncomp, 0);
+  for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    const int i = mfi.index();
+    const amrex::Box& bx = mfi.validbox();
+    std::ifstream dfs(dir + files[i], std::ios::binary);
+    if (!dfs.good()) {
+      amrex::FileOpenFailed(dir + files[i]);
+    }
+
+    // Read the FAB's components, each prefixed by its byte count
+    dfs.seekg(offsets[i]);
+    std::vector<char> in;
+    for (int n = 0; n < ncomp; n++) {
+      constexpr std::size_t head = sizeof(std::uint8_t) + sizeof(double);
+      const std::size_t pos = in.size();
+      in.resize(pos + head + sizeof(std::uint64_t));
+      dfs.read(&in[pos], head + sizeof(std::uint64_t));
+      std::uint64_t nbytes;
+      std::memcpy(&nbytes, &in[pos + head], sizeof(nbytes));
+      in.resize(in.size() + nbytes);
+      dfs.read(&in[in.size() - nbytes], nbytes);
+    }
+    if (!dfs.good()) {
+      amrex::Abort("Failed to read " + dir + files[i]);
+    }
+
+    amrex::FArrayBox hfab(bx, ncomp, amrex::The_Pinned_Arena());
+    const char* p = in.data();
+    for (int n = 0; n < ncomp; n++) {
+      decode_comp(p, hfab, bx, n);
+    }
+    mf[mfi].copy<amrex::RunOn::Device>(hfab, bx);
+    amrex::Gpu::streamSynchronize();
+  }
+}
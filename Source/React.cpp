@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "React.H"
 
 void
@@ -9,6 +11,7 @@ PeleC::react_state(
 {
   // Update I_R, and recompute S_new
   BL_PROFILE("PeleC::react_state()");
+  PerfLogTimer perf_timer(perf_log, level, PerfLog::Reactions);
 
   const amrex::Real strt_time = amrex::ParallelDescriptor::second();
 
@@ -71,13 +74,93 @@ PeleC::react_state(
   react_src.setVal(0.0);
   prefetchToDevice(react_src);
 
+  if (
+    fctCount.empty() || fctCount.boxArray() != grids ||
+    fctCount.DistributionMap() != dmap) {
+    fctCount.define(grids, dmap, 1, ng);
+    fctCount.setVal(0.0);
+  }
+
+#ifdef PELEC_USE_EB
+  auto const& fact =
+    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
+  auto const& flags = fact.getMultiEBCellFlagFab();
+#endif
+
+  // Only cells within the react_T/react_rho bounds are integrated, the
+  // others keep S_old + dt*(non reacting sources) and a zero reaction source
+  amrex::iMultiFab react_mask(grids, dmap, 1, ng);
+  // Tiles with a cell to integrate, flagged while the mask is built so that
+  // the tile loop below needs no reduction per tile
+  const int ntiles =
+    amrex::MFIter(react_mask, amrex::TilingIfNotGPU()).length();
+  amrex::Gpu::DeviceVector<int> tile_active_d(ntiles, 0);
+  amrex::Vector<int> tile_active(ntiles);
+  {
+    int* tile_active_p = tile_active_d.data();
+    const amrex::Real T_min = react_T_min;
+    const amrex::Real T_max = react_T_max;
+    const amrex::Real rho_min = react_rho_min;
+    const amrex::Real rho_max = react_rho_max;
+    const amrex::MultiFab& S_old =
+      react_init ? S_new : get_old_data(State_Type);
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(react_mask, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      const amrex::Box& bx = mfi.growntilebox(ng);
+      const int tile = mfi.LocalTileIndex();
+      auto const& sold_arr = S_old.const_array(mfi);
+      auto const& mask = react_mask.array(mfi);
+#ifdef PELEC_USE_EB
+      auto const& flag = flags.const_array(mfi);
+#endif
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::Real rho = sold_arr(i, j, k, URHO);
+          const amrex::Real T = sold_arr(i, j, k, UTEMP);
+          mask(i, j, k) =
+            (rho >= rho_min && rho <= rho_max && T >= T_min && T <= T_max)
+              ? 1
+              : 0;
+#ifdef PELEC_USE_EB
+          if (flag(i, j, k).isCovered()) {
+            mask(i, j, k) = 0;
+          }
+#endif
+          if (mask(i, j, k) != 0) {
+            tile_active_p[tile] = 1;
+          }
+        });
+    }
+    amrex::Gpu::copy(
+      amrex::Gpu::deviceToHost, tile_active_d.begin(), tile_active_d.end(),
+      tile_active.begin());
+  }
+
+  if (verbose > 1) {
+    const amrex::Long nactive = react_mask.sum(0);
+    amrex::Print() << "... " << nactive << " of " << grids.numPts()
+                   << " cells within the reaction bounds" << std::endl;
+  }
+
+#ifdef AMREX_USE_GPU
+  const bool batched = false;
+#else
+  const bool batched = chem_integrator == 1 && chem_batch_size > 0;
+#endif
+  if (batched) {
+    react_state_batched(
+      dt, react_init, S_new, *non_react_src, react_mask, react_src);
+  }
+
 #ifdef USE_SUNDIALS_PP
   // for sundials box integration
   amrex::MultiFab STemp(grids, dmap, NUM_SPECIES + 2, 0);
   amrex::MultiFab extsrc_rY(grids, dmap, NUM_SPECIES, 0);
   amrex::MultiFab extsrc_rE(grids, dmap, 1, 0);
   amrex::iMultiFab dummyMask(grids, dmap, 1, 0);
-  amrex::MultiFab fctCount(grids, dmap, 1, 0);
   dummyMask.setVal(1);
 
   if (!react_init) {
@@ -96,12 +179,6 @@ PeleC::react_state(
     extsrc_rY, *non_react_src, UFS, 0, NUM_SPECIES, STemp.nGrow());
 #endif
 
-#ifdef PELEC_USE_EB
-  auto const& fact =
-    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
-  auto const& flags = fact.getMultiEBCellFlagFab();
-#endif
-
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -119,6 +196,16 @@ PeleC::react_state(
       auto const& snew_arr = S_new.array(mfi);
       auto const& nonrs_arr = non_react_src->array(mfi);
       auto const& I_R = react_src.array(mfi);
+      auto const& fc = fctCount.array(mfi);
+      auto const& rk_dt = get_new_data(Chem_Dt_Type).array(mfi);
+      auto const& react_mask_arr = react_mask.const_array(mfi);
+
+      // Nothing to integrate in this tile
+      if (tile_active[mfi.LocalTileIndex()] == 0) {
+        continue;
+      }
+
+      const amrex::Real wt = amrex::ParallelDescriptor::second();
 
       // only update beyond first step
       // TODO: Update here? Or just get reaction source?
@@ -130,17 +217,14 @@ PeleC::react_state(
       const auto& flag_fab = flags[mfi];
       amrex::FabType typ = flag_fab.getType(bx);
       if (typ == amrex::FabType::covered) {
-        if (do_react_load_balance) {
-          const amrex::Box vbox = mfi.tilebox();
-          get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(
-            0.0, vbox);
-        }
         continue;
       }
       if (typ == amrex::FabType::singlevalued || typ == amrex::FabType::regular)
 #endif
       {
-        if (chem_integrator == 1) {
+        if (chem_integrator == 1 && batched) {
+          // already integrated by react_state_batched
+        } else if (chem_integrator == 1) {
           // for rk64 we set minimum, maximum and guess
           // number of sub-iterations
           const int nsubsteps_min = adaptrk_nsubsteps_min;
@@ -149,19 +233,35 @@ PeleC::react_state(
 
           // for rk64 we set the error tolerance
           const amrex::Real errtol = adaptrk_errtol;
-
-          amrex::ParallelFor(
-            bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-              pc_expl_reactions(
-                i, j, k, sold_arr, snew_arr, nonrs_arr, I_R, dt, nsubsteps_min,
-                nsubsteps_max, nsubsteps_guess, errtol, do_update,
-                captured_clean_massfrac);
+          const int warm_start = adaptrk_warm_start;
+
+          if (isat_table != nullptr) {
+            ISATTable& table = *isat_table;
+            amrex::LoopOnCpu(bx, [&](int i, int j, int k) noexcept {
+              if (react_mask_arr(i, j, k) != 0) {
+                fc(i, j, k) = pc_isat_reactions(
+                  table, i, j, k, sold_arr, snew_arr, nonrs_arr, I_R, rk_dt,
+                  dt, nsubsteps_min, nsubsteps_max, nsubsteps_guess, errtol,
+                  warm_start, do_update, captured_clean_massfrac);
+              } else {
+                fc(i, j, k) = 0.0;
+              }
             });
+          } else {
+            amrex::ParallelFor(
+              bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                if (react_mask_arr(i, j, k) != 0) {
+                  fc(i, j, k) = pc_expl_reactions(
+                    i, j, k, sold_arr, snew_arr, nonrs_arr, I_R, rk_dt, dt,
+                    nsubsteps_min, nsubsteps_max, nsubsteps_guess, errtol,
+                    warm_start, do_update, captured_clean_massfrac);
+                } else {
+                  fc(i, j, k) = 0.0;
+                }
+              });
+          }
         } else if (chem_integrator == 2) {
 #ifdef USE_SUNDIALS_PP
-          amrex::Real wt =
-            amrex::ParallelDescriptor::second(); // timing for each fab
-
           amrex::Real current_time = 0.0;
 
           auto const& rhoY = STemp.array(mfi);
@@ -170,7 +270,6 @@ PeleC::react_state(
           auto const& frcExt = extsrc_rY.array(mfi);
           auto const& frcEExt = extsrc_rE.array(mfi);
           auto const& mask = dummyMask.array(mfi);
-          auto const& fc = fctCount.array(mfi);
 
           amrex::ParallelFor(
             bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -221,6 +320,10 @@ PeleC::react_state(
           // unpack data
           amrex::ParallelFor(
             bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              if (react_mask_arr(i, j, k) == 0) {
+                return;
+              }
+
               // work on old state
               amrex::Real rhou = sold_arr(i, j, k, UMX);
               amrex::Real rhov = sold_arr(i, j, k, UMY);
@@ -293,14 +396,6 @@ PeleC::react_state(
                   / dt -
                 nonrs_arr(i, j, k, UEDEN);
             });
-
-          wt = (amrex::ParallelDescriptor::second() - wt) / bx.d_numPts();
-
-          if (do_react_load_balance) {
-            const amrex::Box vbox = mfi.tilebox();
-            get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(
-              wt, vbox);
-          }
 #else
           amrex::Abort(
             "chem_integrator=2 which requires Sundials to be enabled");
@@ -332,6 +427,10 @@ PeleC::react_state(
               I_R(i, j, k, NUM_SPECIES + 1) -= hi[nsp] * I_R(i, j, k, nsp);
             }
           });
+
+        if (do_react_load_balance) {
+          add_react_work_estimate(mfi, mfi.tilebox(), wt, react_mask_arr);
+        }
       }
     }
   }
@@ -340,6 +439,33 @@ PeleC::react_state(
     S_new.FillBoundary(geom.periodicity());
   }
 
+  if (perf_log.active()) {
+    // Substeps of the integrated valid cells, reduced over the ranks later
+    amrex::ReduceOps<amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpMax>
+      reduce_op;
+    amrex::ReduceData<amrex::Long, amrex::Long, amrex::Long> reduce_data(
+      reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (amrex::MFIter mfi(fctCount); mfi.isValid(); ++mfi) {
+      auto const& fc = fctCount.const_array(mfi);
+      auto const& mask = react_mask.const_array(mfi);
+      reduce_op.eval(
+        mfi.validbox(), reduce_data,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+          const amrex::Long n =
+            mask(i, j, k) != 0 ? static_cast<amrex::Long>(fc(i, j, k)) : 0;
+          return {mask(i, j, k) != 0 ? 1 : 0, n, n};
+        });
+    }
+    ReduceTuple hv = reduce_data.value(reduce_op);
+    perf_log.addChemistry(
+      level, amrex::get<0>(hv), amrex::get<1>(hv), amrex::get<2>(hv));
+  }
+
+  if (verbose > 1 && isat_table != nullptr) {
+    isat_table->printStats();
+  }
+
   if (verbose > 1) {
     const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
     amrex::Real run_time = amrex::ParallelDescriptor::second() - strt_time;
@@ -357,3 +483,169 @@ PeleC::react_state(
 #endif
   }
 }
+
+// Explicit RK chemistry on batches of chem_batch_size cells. The reacting
+// cells of all the local boxes are gathered in a single list, sorted from
+// the most to the least expensive using the substep counts of the previous
+// call, and copied batch by batch into contiguous storage before being
+// integrated. Batches are handed out dynamically to the OpenMP threads, so
+// a few stiff cells no longer set the cost of a whole tile. Only the cells
+// flagged in react_mask are integrated.
+void
+PeleC::react_state_batched(
+  amrex::Real dt,
+  bool react_init,
+  amrex::MultiFab& S_new,
+  const amrex::MultiFab& non_react_src,
+  const amrex::iMultiFab& react_mask,
+  amrex::MultiFab& react_src)
+{
+  BL_PROFILE("PeleC::react_state_batched()");
+
+  const int ng = S_new.nGrow();
+  const amrex::MultiFab& S_old =
+    react_init ? S_new : get_old_data(State_Type);
+
+  struct ReactCell
+  {
+    int fab;
+    int i, j, k;
+    amrex::Real cost;
+  };
+  amrex::Vector<ReactCell> cells;
+  amrex::Vector<amrex::Array4<const amrex::Real>> sold_arrs;
+  amrex::Vector<amrex::Array4<const amrex::Real>> nonrs_arrs;
+  amrex::Vector<amrex::Array4<amrex::Real>> snew_arrs;
+  amrex::Vector<amrex::Array4<amrex::Real>> IR_arrs;
+  amrex::Vector<amrex::Array4<amrex::Real>> fc_arrs;
+  amrex::Vector<amrex::Array4<amrex::Real>> rk_dt_arrs;
+  amrex::Vector<amrex::Array4<amrex::Real>> work_arrs;
+  amrex::Vector<amrex::Box> valid_boxes;
+
+  for (amrex::MFIter mfi(S_new); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.growntilebox(ng);
+
+    const int fab = sold_arrs.size();
+    sold_arrs.push_back(S_old.const_array(mfi));
+    nonrs_arrs.push_back(non_react_src.const_array(mfi));
+    snew_arrs.push_back(S_new.array(mfi));
+    IR_arrs.push_back(react_src.array(mfi));
+    fc_arrs.push_back(fctCount.array(mfi));
+    rk_dt_arrs.push_back(get_new_data(Chem_Dt_Type).array(mfi));
+    if (do_react_load_balance) {
+      work_arrs.push_back(get_new_data(Work_Estimate_Type).array(mfi));
+      valid_boxes.push_back(mfi.validbox());
+    }
+
+    auto const& fc = fc_arrs[fab];
+    auto const& mask = react_mask.const_array(mfi);
+    amrex::LoopOnCpu(bx, [&](int i, int j, int k) {
+      if (mask(i, j, k) != 0) {
+        cells.push_back({fab, i, j, k, fc(i, j, k)});
+      }
+    });
+  }
+
+  std::stable_sort(
+    cells.begin(), cells.end(),
+    [](const ReactCell& a, const ReactCell& b) { return a.cost > b.cost; });
+
+  const int ncells = cells.size();
+  const int batch_size = chem_batch_size;
+  const int nbatch = (ncells + batch_size - 1) / batch_size;
+  const int do_update = react_init ? 0 : 1;
+  const int nsubsteps_min = adaptrk_nsubsteps_min;
+  const int nsubsteps_max = adaptrk_nsubsteps_max;
+  const int nsubsteps_guess = adaptrk_nsubsteps_guess;
+  const amrex::Real errtol = adaptrk_errtol;
+  const int warm_start = adaptrk_warm_start;
+  const int captured_clean_massfrac = clean_massfrac;
+  const int nIR = NUM_SPECIES + 1;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int b = 0; b < nbatch; b++) {
+    const amrex::Real wt = amrex::ParallelDescriptor::second();
+    const int first = b * batch_size;
+    const int nb = amrex::min(batch_size, ncells - first);
+    const amrex::Box bbox(
+      amrex::IntVect::TheZeroVector(),
+      amrex::IntVect(AMREX_D_DECL(nb - 1, 0, 0)));
+
+    ScratchFab sold_b(scratch_pool, bbox, NVAR);
+    ScratchFab snew_b(scratch_pool, bbox, NVAR);
+    ScratchFab nonrs_b(scratch_pool, bbox, NVAR);
+    ScratchFab IR_b(scratch_pool, bbox, nIR);
+    ScratchFab rk_dt_b(scratch_pool, bbox, 1);
+    auto const& sold = sold_b.array();
+    auto const& snew = snew_b.array();
+    auto const& nonrs = nonrs_b.array();
+    auto const& IR = IR_b.array();
+    auto const& rk_dt = rk_dt_b.array();
+
+    // Gather
+    for (int n = 0; n < NVAR; n++) {
+      for (int c = 0; c < nb; c++) {
+        const ReactCell& cell = cells[first + c];
+        sold(c, 0, 0, n) = sold_arrs[cell.fab](cell.i, cell.j, cell.k, n);
+        snew(c, 0, 0, n) = snew_arrs[cell.fab](cell.i, cell.j, cell.k, n);
+        nonrs(c, 0, 0, n) = nonrs_arrs[cell.fab](cell.i, cell.j, cell.k, n);
+      }
+    }
+    for (int c = 0; c < nb; c++) {
+      const ReactCell& cell = cells[first + c];
+      rk_dt(c, 0, 0) = rk_dt_arrs[cell.fab](cell.i, cell.j, cell.k);
+    }
+
+    for (int c = 0; c < nb; c++) {
+      const ReactCell& cell = cells[first + c];
+      fc_arrs[cell.fab](cell.i, cell.j, cell.k) =
+        isat_table != nullptr
+          ? pc_isat_reactions(
+              *isat_table, c, 0, 0, sold, snew, nonrs, IR, rk_dt, dt,
+              nsubsteps_min, nsubsteps_max, nsubsteps_guess, errtol,
+              warm_start, do_update, captured_clean_massfrac)
+          : pc_expl_reactions(
+              c, 0, 0, sold, snew, nonrs, IR, rk_dt, dt, nsubsteps_min,
+              nsubsteps_max, nsubsteps_guess, errtol, warm_start, do_update,
+              captured_clean_massfrac);
+      rk_dt_arrs[cell.fab](cell.i, cell.j, cell.k) = rk_dt(c, 0, 0);
+    }
+
+    // Scatter
+    for (int n = 0; n < NVAR; n++) {
+      for (int c = 0; c < nb; c++) {
+        const ReactCell& cell = cells[first + c];
+        snew_arrs[cell.fab](cell.i, cell.j, cell.k, n) = snew(c, 0, 0, n);
+      }
+    }
+    for (int n = 0; n < nIR; n++) {
+      for (int c = 0; c < nb; c++) {
+        const ReactCell& cell = cells[first + c];
+        IR_arrs[cell.fab](cell.i, cell.j, cell.k, n) = IR(c, 0, 0, n);
+      }
+    }
+
+    // Charge the batch time evenly to its valid cells
+    if (do_react_load_balance) {
+      const amrex::Real wt_cell =
+        (amrex::ParallelDescriptor::second() - wt) / nb;
+      for (int c = 0; c < nb; c++) {
+        const ReactCell& cell = cells[first + c];
+        const amrex::IntVect iv(AMREX_D_DECL(cell.i, cell.j, cell.k));
+        if (valid_boxes[cell.fab].contains(iv)) {
+          work_arrs[cell.fab](cell.i, cell.j, cell.k) += wt_cell;
+        }
+      }
+    }
+  }
+
+  if (verbose > 1) {
+    amrex::Long nbatch_tot = nbatch;
+    amrex::ParallelDescriptor::ReduceLongSum(
+      nbatch_tot, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "... " << nbatch_tot << " chemistry batches"
+                   << std::endl;
+  }
+}
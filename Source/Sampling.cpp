@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include "PeleC.H"
+#include "Sampling.H"
+
+SamplingParm
+pc_read_sampling_params()
+{
+  SamplingParm sp;
+  amrex::ParmParse pp("sampling");
+  pp.query("int", sp.interval);
+  pp.query("dir", sp.dir);
+  amrex::Vector<std::string> labels;
+  pp.queryarr("labels", labels);
+
+  auto& samplers = sp.samplers;
+  for (const auto& label : labels) {
+    amrex::ParmParse pps("sampling." + label);
+    Sampler s;
+    s.name = label;
+    pps.getarr("fields", s.fields);
+
+    auto get_point = [&](const char* key) {
+      amrex::Vector<amrex::Real> v;
+      pps.getarr(key, v, 0, AMREX_SPACEDIM);
+      return amrex::RealVect(AMREX_D_DECL(v[0], v[1], v[2]));
+    };
+
+    std::string type;
+    pps.get("type", type);
+    if (type == "probes") {
+      s.type = Sampler::Probes;
+      amrex::Vector<amrex::Real> loc;
+      pps.getarr("locations", loc);
+      if (loc.empty() || loc.size() % AMREX_SPACEDIM != 0) {
+        amrex::Abort(
+          "sampling." + label + ".locations needs AMREX_SPACEDIM values "
+          "per probe");
+      }
+      for (int p = 0; p < loc.size(); p += AMREX_SPACEDIM) {
+        s.points.push_back(
+          amrex::RealVect(AMREX_D_DECL(loc[p], loc[p + 1], loc[p + 2])));
+      }
+      s.shape[0] = s.points.size();
+    } else if (type == "line") {
+      s.type = Sampler::Line;
+      const amrex::RealVect start = get_point("start");
+      const amrex::RealVect end = get_point("end");
+      pps.get("num_points", s.shape[0]);
+      if (s.shape[0] < 2) {
+        amrex::Abort("sampling." + label + ".num_points must be at least 2");
+      }
+      for (int n = 0; n < s.shape[0]; n++) {
+        const amrex::Real f = static_cast<amrex::Real>(n) / (s.shape[0] - 1);
+        s.points.push_back(start + f * (end - start));
+      }
+    } else if (type == "plane") {
+      // origin + a1 * axis1 + a2 * axis2 for a1, a2 in [0, 1]
+      s.type = Sampler::Plane;
+      const amrex::RealVect origin = get_point("origin");
+      const amrex::RealVect axis1 = get_point("axis1");
+      const amrex::RealVect axis2 = get_point("axis2");
+      amrex::Vector<int> np;
+      pps.getarr("num_points", np, 0, 2);
+      if (np[0] < 2 || np[1] < 2) {
+        amrex::Abort("sampling." + label + ".num_points must be at least 2");
+      }
+      s.shape[0] = np[0];
+      s.shape[1] = np[1];
+      for (int n2 = 0; n2 < np[1]; n2++) {
+        const amrex::Real f2 = static_cast<amrex::Real>(n2) / (np[1] - 1);
+        for (int n1 = 0; n1 < np[0]; n1++) {
+          const amrex::Real f1 = static_cast<amrex::Real>(n1) / (np[0] - 1);
+          s.points.push_back(origin + f1 * axis1 + f2 * axis2);
+        }
+      }
+    } else {
+      amrex::Abort(
+        "sampling." + label + ".type must be probes, line or plane, not " +
+        type);
+    }
+    samplers.push_back(s);
+  }
+  return sp;
+}
+
+void
+PeleC::write_samples()
+{
+  BL_PROFILE("PeleC::write_samples()");
+
+  const auto& samplers = sampling_parm.samplers;
+  const std::string& sampling_dir = sampling_parm.dir;
+  if (samplers.empty()) {
+    return;
+  }
+
+  const int finest_level = parent->finestLevel();
+  const int nstep = parent->levelSteps(0);
+  const amrex::Real time = state[State_Type].curTime();
+  const amrex::RealBox& prob_domain = geom.ProbDomain();
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    if (!amrex::UtilCreateDirectory(sampling_dir, 0755)) {
+      amrex::CreateDirectoryFailed(sampling_dir);
+    }
+  }
+  amrex::ParallelDescriptor::Barrier();
+
+  // Every field sampled, each derived once per level for all the samplers
+  amrex::Vector<std::string> fields;
+  for (const auto& s : samplers) {
+    for (const auto& x : s.points) {
+      if (!prob_domain.contains(x.dataPtr())) {
+        amrex::Abort("Sample point of " + s.name + " outside of the domain");
+      }
+    }
+    for (const auto& f : s.fields) {
+      if (std::find(fields.begin(), fields.end(), f) == fields.end()) {
+        fields.push_back(f);
+      }
+    }
+  }
+  const int nfields = fields.size();
+
+  // Values of each sampler and the level they were interpolated on
+  const int nsamplers = samplers.size();
+  amrex::Vector<amrex::Vector<amrex::Real>> vals(nsamplers);
+  amrex::Vector<amrex::Vector<int>> plev(nsamplers);
+  amrex::Vector<amrex::Vector<int>> field_index(nsamplers);
+  for (int is = 0; is < nsamplers; is++) {
+    const auto& s = samplers[is];
+    vals[is].resize(s.points.size() * s.fields.size(), 0.0);
+    plev[is].resize(s.points.size(), -1);
+    for (const auto& f : s.fields) {
+      field_index[is].push_back(
+        std::find(fields.begin(), fields.end(), f) - fields.begin());
+    }
+  }
+
+  // Interpolate on every level, the finest level containing a point wins
+  for (int lev = 0; lev <= finest_level; lev++) {
+    PeleC& pc_lev = getLevel(lev);
+    const amrex::BoxArray& ba = pc_lev.boxArray();
+    const amrex::DistributionMapping& dm = pc_lev.DistributionMap();
+    const amrex::Geometry& lgeom = pc_lev.Geom();
+    const auto plo = lgeom.ProbLoArray();
+    const auto dxinv = lgeom.InvCellSizeArray();
+    const amrex::Box& ldomain = lgeom.Domain();
+
+    // Fields with one ghost cell for the interpolation stencil. The fills
+    // are collective, so every rank derives them.
+    amrex::MultiFab data(ba, dm, nfields, 1);
+    for (int n = 0; n < nfields; n++) {
+      auto mf = pc_lev.derive(fields[n], time, 1);
+      amrex::MultiFab::Copy(data, *mf, 0, n, 1, 1);
+    }
+
+    for (int is = 0; is < nsamplers; is++) {
+      const auto& s = samplers[is];
+      const int npts = s.points.size();
+      const int nf = s.fields.size();
+
+      // Points in each locally owned box of this level
+      std::map<int, amrex::Vector<int>> box_points;
+      for (int p = 0; p < npts; p++) {
+        amrex::IntVect iv;
+        for (int d = 0; d < AMREX_SPACEDIM; d++) {
+          iv[d] = static_cast<int>(
+            amrex::Math::floor((s.points[p][d] - plo[d]) * dxinv[d]));
+          iv[d] = amrex::min(
+            amrex::max(iv[d], ldomain.smallEnd(d)), ldomain.bigEnd(d));
+        }
+        const auto isects = ba.intersections(amrex::Box(iv, iv), true, 0);
+        if (!isects.empty() && dm[isects[0].first] == myproc) {
+          box_points[isects[0].first].push_back(p);
+        }
+      }
+
+      amrex::Gpu::DeviceVector<int> d_comp(nf);
+      amrex::Gpu::copy(
+        amrex::Gpu::hostToDevice, field_index[is].begin(),
+        field_index[is].end(), d_comp.begin());
+      const int* comp = d_comp.data();
+
+      for (amrex::MFIter mfi(data); mfi.isValid(); ++mfi) {
+        auto it = box_points.find(mfi.index());
+        if (it == box_points.end()) {
+          continue;
+        }
+        const auto& ids = it->second;
+        const int nbp = ids.size();
+        amrex::Vector<amrex::Real> h_x(nbp * AMREX_SPACEDIM);
+        for (int m = 0; m < nbp; m++) {
+          for (int d = 0; d < AMREX_SPACEDIM; d++) {
+            h_x[m * AMREX_SPACEDIM + d] = s.points[ids[m]][d];
+          }
+        }
+        amrex::Gpu::DeviceVector<amrex::Real> d_x(h_x.size());
+        amrex::Gpu::DeviceVector<amrex::Real> d_v(nbp * nf);
+        amrex::Gpu::copy(
+          amrex::Gpu::hostToDevice, h_x.begin(), h_x.end(), d_x.begin());
+        const amrex::Real* xp = d_x.data();
+        amrex::Real* vp = d_v.data();
+        const auto arr = data.const_array(mfi);
+
+        amrex::ParallelFor(nbp, [=] AMREX_GPU_DEVICE(int m) noexcept {
+          for (int n = 0; n < nf; n++) {
+            vp[m * nf + n] = pc_sample_interp(
+              xp + m * AMREX_SPACEDIM, plo, dxinv, arr, comp[n]);
+          }
+        });
+
+        amrex::Vector<amrex::Real> h_v(nbp * nf);
+        amrex::Gpu::copy(
+          amrex::Gpu::deviceToHost, d_v.begin(), d_v.end(), h_v.begin());
+        for (int m = 0; m < nbp; m++) {
+          plev[is][ids[m]] = lev;
+          for (int n = 0; n < nf; n++) {
+            vals[is][ids[m] * nf + n] = h_v[m * nf + n];
+          }
+        }
+      }
+    }
+  }
+
+  for (int is = 0; is < nsamplers; is++) {
+    const auto& s = samplers[is];
+    const int npts = s.points.size();
+    const int nf = s.fields.size();
+    auto& svals = vals[is];
+
+    // Keep only the values of the finest level, held by a single rank
+    amrex::Vector<int> glev(plev[is]);
+    amrex::ParallelDescriptor::ReduceIntMax(glev.dataPtr(), npts);
+    for (int p = 0; p < npts; p++) {
+      if (plev[is][p] != glev[p]) {
+        for (int n = 0; n < nf; n++) {
+          svals[p * nf + n] = 0.0;
+        }
+      }
+    }
+    amrex::ParallelDescriptor::ReduceRealSum(
+      svals.dataPtr(), npts * nf, ioproc);
+
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+      // ASCII header, then the coordinates and the values of each field as
+      // doubles in native byte order
+      const std::string fname =
+        sampling_dir + "/" + amrex::Concatenate(s.name, nstep, 5);
+      std::ofstream ofs(fname, std::ios::binary);
+      if (!ofs.good()) {
+        amrex::FileOpenFailed(fname);
+      }
+      static const char* type_names[] = {"probes", "line", "plane"};
+      ofs << "PeleC_sample_v1\n"
+          << s.name << " " << type_names[s.type] << "\n"
+          << nstep << " " << std::setprecision(17) << time << "\n"
+          << AMREX_SPACEDIM << " " << s.shape[0] << " " << s.shape[1]
+          << "\n"
+          << nf;
+      for (const auto& f : s.fields) {
+        ofs << " " << f;
+      }
+      ofs << "\n";
+      amrex::Vector<double> buf(npts);
+      for (int d = 0; d < AMREX_SPACEDIM; d++) {
+        for (int p = 0; p < npts; p++) {
+          buf[p] = s.points[p][d];
+        }
+        ofs.write(
+          reinterpret_cast<const char*>(buf.data()), npts * sizeof(double));
+      }
+      for (int n = 0; n < nf; n++) {
+        for (int p = 0; p < npts; p++) {
+          buf[p] = svals[p * nf + n];
+        }
+        ofs.write(
+          reinterpret_cast<const char*>(buf.data()), npts * sizeof(double));
+      }
+    }
+  }
+}
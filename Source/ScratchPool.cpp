@@ -0,0 +1,203 @@
+#include <AMReX_Arena.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include "ScratchPool.H"
+
+bool ScratchFabPool::s_enabled = true;
+amrex::Long ScratchFabPool::s_max_bytes = 0;
+
+ScratchFabPool::ScratchFabPool() : m_threads(amrex::OpenMP::get_max_threads())
+{
+}
+
+ScratchFabPool::~ScratchFabPool() { clear(); }
+
+bool
+ScratchFabPool::active()
+{
+#ifdef AMREX_USE_GPU
+  return false;
+#else
+  return s_enabled;
+#endif
+}
+
+amrex::Real*
+ScratchFabPool::acquire(const amrex::Box& bx, int ncomp, int& slot)
+{
+  ThreadSlots& ts = m_threads[amrex::OpenMP::get_thread_num()];
+  const std::size_t nbytes = bx.numPts() * ncomp * sizeof(amrex::Real);
+
+  // Best fit among the idle slots that are large enough
+  int best = -1;
+  for (int n = 0; n < ts.slots.size(); n++) {
+    const Slot& s = ts.slots[n];
+    if (
+      !s.busy && s.ptr != nullptr && s.nbytes >= nbytes &&
+      (best < 0 || s.nbytes < ts.slots[best].nbytes)) {
+      best = n;
+    }
+  }
+  if (best >= 0) {
+    ts.slots[best].busy = true;
+    ts.hits++;
+    slot = best;
+    return ts.slots[best].ptr;
+  }
+
+  BL_PROFILE("ScratchFabPool::alloc()");
+  evict_free(ts, nbytes);
+
+  // Replace the largest idle slot, which is too small for this request, so
+  // that the number of slots stays at the number used at once. Otherwise
+  // take an evicted entry or append one; the indices of the slots currently
+  // in use must stay valid.
+  int n = -1;
+  for (int m = 0; m < ts.slots.size(); m++) {
+    const Slot& s = ts.slots[m];
+    if (
+      !s.busy &&
+      (n < 0 || s.ptr == nullptr || s.nbytes > ts.slots[n].nbytes)) {
+      n = m;
+      if (s.ptr == nullptr) {
+        break;
+      }
+    }
+  }
+  if (n < 0) {
+    n = ts.slots.size();
+    ts.slots.push_back(Slot());
+  }
+
+  Slot& s = ts.slots[n];
+  if (s.ptr != nullptr) {
+    ts.bytes -= s.nbytes;
+    amrex::The_Arena()->free(s.ptr);
+  }
+  s.nbytes = nbytes;
+  s.ptr = static_cast<amrex::Real*>(amrex::The_Arena()->alloc(nbytes));
+  s.busy = true;
+  ts.misses++;
+  ts.bytes += nbytes;
+  slot = n;
+  return s.ptr;
+}
+
+void
+ScratchFabPool::release(int slot)
+{
+  ThreadSlots& ts = m_threads[amrex::OpenMP::get_thread_num()];
+  AMREX_ASSERT(slot >= 0 && slot < ts.slots.size() && ts.slots[slot].busy);
+  ts.slots[slot].busy = false;
+}
+
+void
+ScratchFabPool::evict_free(ThreadSlots& ts, std::size_t need)
+{
+  if (s_max_bytes <= 0) {
+    return;
+  }
+  while (ts.bytes + static_cast<amrex::Long>(need) > s_max_bytes) {
+    int n = -1;
+    for (int m = 0; m < ts.slots.size(); m++) {
+      const Slot& s = ts.slots[m];
+      if (
+        !s.busy && s.ptr != nullptr &&
+        (n < 0 || s.nbytes > ts.slots[n].nbytes)) {
+        n = m;
+      }
+    }
+    if (n < 0) {
+      // Everything left is in use, go over the cap rather than fail
+      return;
+    }
+    ts.bytes -= ts.slots[n].nbytes;
+    amrex::The_Arena()->free(ts.slots[n].ptr);
+    ts.slots[n] = Slot();
+  }
+}
+
+void
+ScratchFabPool::clear()
+{
+  for (auto& ts : m_threads) {
+    for (auto& s : ts.slots) {
+      AMREX_ASSERT(!s.busy);
+      if (s.ptr != nullptr) {
+        amrex::The_Arena()->free(s.ptr);
+      }
+    }
+    ts.slots.clear();
+    ts.bytes = 0;
+  }
+}
+
+amrex::Long
+ScratchFabPool::numHits() const
+{
+  amrex::Long n = 0;
+  for (const auto& ts : m_threads) {
+    n += ts.hits;
+  }
+  return n;
+}
+
+amrex::Long
+ScratchFabPool::numMisses() const
+{
+  amrex::Long n = 0;
+  for (const auto& ts : m_threads) {
+    n += ts.misses;
+  }
+  return n;
+}
+
+amrex::Long
+ScratchFabPool::numBytes() const
+{
+  amrex::Long n = 0;
+  for (const auto& ts : m_threads) {
+    n += ts.bytes;
+  }
+  return n;
+}
+
+void
+ScratchFabPool::printStats(const std::string& name) const
+{
+  amrex::Long stats[3] = {numHits(), numMisses(), numBytes()};
+  amrex::ParallelDescriptor::ReduceLongSum(
+    stats, 3, amrex::ParallelDescriptor::IOProcessorNumber());
+  amrex::Print() << "    " << name << " scratch pool: " << stats[0]
+                 << " hits, " << stats[1] << " misses, " << stats[2]
+                 << " bytes held" << std::endl;
+}
+
+void
+ScratchFab::define(ScratchFabPool& pool, const amrex::Box& bx, int ncomp)
+{
+  clear();
+  if (ScratchFabPool::active()) {
+    m_pool = &pool;
+    amrex::Real* p = pool.acquire(bx, ncomp, m_slot);
+    static_cast<amrex::FArrayBox&>(*this) = amrex::FArrayBox(bx, ncomp, p);
+  } else {
+    resize(bx, ncomp);
+    m_eli = elixir();
+  }
+}
+
+void
+ScratchFab::clear()
+{
+  if (m_pool != nullptr) {
+    static_cast<amrex::FArrayBox&>(*this) = amrex::FArrayBox();
+    m_pool->release(m_slot);
+    m_pool = nullptr;
+    m_slot = -1;
+  } else {
+    m_eli.clear();
+  }
+}
@@ -436,6 +436,15 @@ PeleC::variableSetUp()
   bndryfunc2.setRunOnGPU(true);
 
   desc_lst.setComponent(Reactions_Type, 0, react_name, react_bcs, bndryfunc2);
+
+  // Last adaptive substep size of the explicit chemistry integrator, used to
+  // warm-start the integration of the next step
+  desc_lst.addDescriptor(
+    Chem_Dt_Type, amrex::IndexType::TheCellType(),
+    amrex::StateDescriptor::Point, 0, 1, &amrex::pc_interp);
+  desc_lst.setComponent(
+    Chem_Dt_Type, 0, "chem_dt", bc,
+    amrex::StateDescriptor::BndryFunc(pc_nullfill));
 #endif
 
   if (do_react_load_balance || do_mol_load_balance) {
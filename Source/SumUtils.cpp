@@ -1,4 +1,5 @@
 #include "PeleC.H"
+#include "SumIQ.H"
 
 amrex::Real
 PeleC::sumDerive(const std::string& name, amrex::Real time, bool local)
@@ -64,6 +65,96 @@ PeleC::volWgtSum(
   return sum;
 }
 
+void
+PeleC::volWgtSumIQ(
+  amrex::Real time, const int iq_mask, amrex::Real sums[IQ_NUM], bool finemask)
+{
+  BL_PROFILE("PeleC::volWgtSumIQ()");
+
+  // Only the enstrophy needs neighboring cells
+  const bool need_ghosts = (iq_mask & (1 << IQ_ENSTROPHY)) != 0;
+  amrex::MultiFab Sborder;
+  if (need_ghosts) {
+    Sborder.define(grids, dmap, NVAR, 1, amrex::MFInfo(), Factory());
+    FillPatch(*this, Sborder, 1, time, State_Type, 0, NVAR);
+  }
+  const amrex::MultiFab& S = need_ghosts ? Sborder : get_data(State_Type, time);
+
+  int fuel_comp = -1;
+#ifdef PELEC_USE_REACTIONS
+  const amrex::MultiFab& R = get_data(Reactions_Type, time);
+  for (int n = 0; n < spec_names.size(); n++) {
+    if (spec_names[n] == fuel_name) {
+      fuel_comp = n;
+    }
+  }
+#endif
+
+  const bool use_mask = level < parent->finestLevel() && finemask;
+  const amrex::MultiFab* mask =
+    use_mask ? &getLevel(level + 1).build_fine_mask() : nullptr;
+  const auto dxinv = geom.InvCellSizeArray();
+
+  amrex::ReduceOps<
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum>
+    reduce_op;
+  amrex::ReduceData<
+    amrex::Real, amrex::Real, amrex::Real, amrex::Real, amrex::Real,
+    amrex::Real, amrex::Real, amrex::Real, amrex::Real, amrex::Real>
+    reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+  static_assert(IQ_NUM == 10, "ReduceOps must have one entry per quantity");
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    auto const& u = S.const_array(mfi);
+    auto const& vol = volume.const_array(mfi);
+    const amrex::Array4<const amrex::Real> fmask =
+      use_mask ? mask->const_array(mfi) : amrex::Array4<const amrex::Real>();
+#ifdef PELEC_USE_REACTIONS
+    auto const& react = R.const_array(mfi);
+#else
+    const amrex::Array4<const amrex::Real> react;
+#endif
+#ifdef PELEC_USE_EB
+    auto const& vf = vfrac.const_array(mfi);
+#endif
+    reduce_op.eval(
+      bx, reduce_data,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+        amrex::Real w = vol(i, j, k);
+        if (use_mask) {
+          w *= fmask(i, j, k);
+        }
+#ifdef PELEC_USE_EB
+        w *= vf(i, j, k);
+#endif
+        amrex::Real iq[IQ_NUM];
+        pc_sum_iq(i, j, k, iq_mask, w, u, react, fuel_comp, dxinv, iq);
+        return {iq[0], iq[1], iq[2], iq[3], iq[4],
+                iq[5], iq[6], iq[7], iq[8], iq[9]};
+      });
+  }
+
+  const ReduceTuple hv = reduce_data.value(reduce_op);
+  sums[0] = amrex::get<0>(hv);
+  sums[1] = amrex::get<1>(hv);
+  sums[2] = amrex::get<2>(hv);
+  sums[3] = amrex::get<3>(hv);
+  sums[4] = amrex::get<4>(hv);
+  sums[5] = amrex::get<5>(hv);
+  sums[6] = amrex::get<6>(hv);
+  sums[7] = amrex::get<7>(hv);
+  sums[8] = amrex::get<8>(hv);
+  sums[9] = amrex::get<9>(hv);
+}
+
 amrex::Real
 PeleC::volWgtSquaredSum(const std::string& name, amrex::Real time, bool local)
 {
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cmath>
+
+#include <AMReX.H>
+
+#include "TabulatedProfile.H"
+
+void
+TabulatedProfile::define(
+  const amrex::Vector<amrex::Real>& x,
+  const amrex::Vector<amrex::Real>& y,
+  int ncol)
+{
+  const int n = x.size();
+  if (n < 1 || ncol < 0 || y.size() != static_cast<long>(n) * ncol) {
+    amrex::Abort("TabulatedProfile: inconsistent table sizes");
+  }
+  if (!std::is_sorted(x.begin(), x.end())) {
+    amrex::Abort("TabulatedProfile: abscissae must be ascending");
+  }
+
+  m_ncol = ncol;
+  m_x = x;
+
+  amrex::Vector<amrex::Real> cumint(y.size(), 0.0);
+  for (int j = 0; j < ncol; j++) {
+    const long off = static_cast<long>(n) * j;
+    for (int i = 1; i < n; i++) {
+      cumint[off + i] = cumint[off + i - 1] +
+                        0.5 * (y[off + i - 1] + y[off + i]) * (x[i] - x[i - 1]);
+    }
+  }
+
+  // Uniform spacing lets interval() skip the binary search
+  amrex::Real dx_uniform = 0.0;
+  if (n > 2) {
+    const amrex::Real h = (x[n - 1] - x[0]) / (n - 1);
+    bool uniform = h > 0.0;
+    for (int i = 1; i < n && uniform; i++) {
+      uniform = std::abs((x[i] - x[i - 1]) - h) <= 1.0e-6 * h;
+    }
+    dx_uniform = uniform ? h : 0.0;
+  }
+
+  m_d_x.resize(x.size());
+  m_d_y.resize(y.size());
+  m_d_cumint.resize(cumint.size());
+  amrex::Gpu::copy(amrex::Gpu::hostToDevice, x.begin(), x.end(), m_d_x.begin());
+  amrex::Gpu::copy(amrex::Gpu::hostToDevice, y.begin(), y.end(), m_d_y.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, cumint.begin(), cumint.end(),
+    m_d_cumint.begin());
+
+  m_data.n = n;
+  m_data.ncol = ncol;
+  m_data.dx_uniform = dx_uniform;
+  m_data.x = m_d_x.data();
+  m_data.y = m_d_y.data();
+  m_data.cumint = m_d_cumint.data();
+}
@@ -1,41 +1,202 @@
 #include <AMReX_ParmParse.H>
 
+#include "mechanism.H"
 #include "PeleC.H"
 #include "Tagging.H"
 
+namespace {
+
+// Map a derived field name to the quantity (and species) a criterion uses
+bool
+tag_quantity_from_name(
+  const std::string& field,
+  const amrex::Vector<std::string>& spec_names,
+  int& quantity,
+  int& comp)
+{
+  comp = 0;
+  if (field == "density") {
+    quantity = TAG_DENSITY;
+  } else if (field == "pressure") {
+    quantity = TAG_PRESSURE;
+  } else if (field == "x_velocity") {
+    quantity = TAG_XVEL;
+  } else if (field == "y_velocity") {
+    quantity = TAG_YVEL;
+  } else if (field == "z_velocity") {
+    quantity = TAG_ZVEL;
+  } else if (field == "magvort") {
+    quantity = TAG_MAGVORT;
+  } else if (field == "Temp") {
+    quantity = TAG_TEMP;
+#ifdef PELEC_USE_EB
+  } else if (field == "vfrac") {
+    quantity = TAG_VFRAC;
+#endif
+  } else {
+    for (int n = 0; n < spec_names.size(); n++) {
+      if (field == "Y(" + spec_names[n] + ")") {
+        quantity = TAG_MASSFRAC;
+        comp = n;
+        return true;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
 void
 PeleC::read_tagging_params()
 {
   amrex::ParmParse pp("tagging");
+  auto& criteria = tagging_parm->criteria;
+  criteria.clear();
+
+  amrex::Vector<std::string> species;
+  CKSYMS_STR(species);
+
+  int ftrac_idx = -1;
+  if (!flame_trac_name.empty()) {
+    for (int n = 0; n < species.size(); ++n) {
+      if (flame_trac_name == species[n]) {
+        ftrac_idx = n;
+      }
+    }
+    if (ftrac_idx < 0) {
+      amrex::Abort("Unknown species identified as flame_trac_name");
+    }
+  }
 
-  pp.query("denerr", tagging_parm->denerr);
-  pp.query("max_denerr_lev", tagging_parm->max_denerr_lev);
-  pp.query("dengrad", tagging_parm->dengrad);
-  pp.query("max_dengrad_lev", tagging_parm->max_dengrad_lev);
+  // Legacy criteria: only added if their threshold is given
+  auto legacy_crit = [&](
+                       const std::string& name, const int quantity,
+                       const int comp, const int mode,
+                       const amrex::Real level_ratio = 1.0) {
+    TaggingParm::Entry e;
+    if (pp.query(name.c_str(), e.crit.value) == 0) {
+      return;
+    }
+    e.name = name;
+    e.crit.quantity = quantity;
+    e.crit.comp = comp;
+    e.crit.mode = mode;
+    e.max_level = 10;
+    pp.query(("max_" + name + "_lev").c_str(), e.max_level);
+    e.level_ratio = level_ratio;
+    criteria.push_back(e);
+  };
 
-  pp.query("presserr", tagging_parm->presserr);
-  pp.query("max_presserr_lev", tagging_parm->max_presserr_lev);
-  pp.query("pressgrad", tagging_parm->pressgrad);
-  pp.query("max_pressgrad_lev", tagging_parm->max_pressgrad_lev);
+  legacy_crit("denerr", TAG_DENSITY, 0, TAG_GREATER);
+  legacy_crit("dengrad", TAG_DENSITY, 0, TAG_GRAD);
+  legacy_crit("presserr", TAG_PRESSURE, 0, TAG_GREATER);
+  legacy_crit("pressgrad", TAG_PRESSURE, 0, TAG_GRAD);
+  for (int dir = 0; dir < 3; dir++) {
+    legacy_crit("velerr", TAG_XVEL + dir, 0, TAG_ABS_GREATER);
+    legacy_crit("velgrad", TAG_XVEL + dir, 0, TAG_GRAD);
+  }
+  legacy_crit("vorterr", TAG_MAGVORT, 0, TAG_ABS_GREATER, 2.0);
+  legacy_crit("temperr", TAG_TEMP, 0, TAG_GREATER);
+  legacy_crit("tempgrad", TAG_TEMP, 0, TAG_GRAD);
+  if (ftrac_idx >= 0) {
+    legacy_crit("ftracerr", TAG_MASSFRAC, ftrac_idx, TAG_GREATER);
+    legacy_crit("ftracgrad", TAG_MASSFRAC, ftrac_idx, TAG_GRAD);
+  }
+#ifdef PELEC_USE_EB
+  {
+    // Cut cells are always tagged below max_vfracerr_lev
+    TaggingParm::Entry e;
+    e.name = "vfracerr";
+    e.crit.quantity = TAG_VFRAC;
+    e.crit.mode = TAG_BETWEEN;
+    e.crit.value = 0.0;
+    e.crit.value_hi = 1.0;
+    e.max_level = 10;
+    pp.query("max_vfracerr_lev", e.max_level);
+    criteria.push_back(e);
+  }
+#endif
 
-  pp.query("velerr", tagging_parm->velerr);
-  pp.query("max_velerr_lev", tagging_parm->max_velerr_lev);
-  pp.query("velgrad", tagging_parm->velgrad);
-  pp.query("max_velgrad_lev", tagging_parm->max_velgrad_lev);
+  // Named criteria: tagging.refinement_indicators = name1 name2 ...
+  amrex::Vector<std::string> names;
+  pp.queryarr("refinement_indicators", names);
+  for (const auto& name : names) {
+    amrex::ParmParse ppc("tagging." + name);
+    TaggingParm::Entry e;
+    e.name = name;
 
-  pp.query("vorterr", tagging_parm->vorterr);
-  pp.query("max_vorterr_lev", tagging_parm->max_vorterr_lev);
+    std::string field;
+    ppc.get("field_name", field);
+    if (!tag_quantity_from_name(
+          field, species, e.crit.quantity, e.crit.comp)) {
+      amrex::Abort(
+        "Unknown field_name " + field + " for tagging criterion " + name);
+    }
 
-  pp.query("temperr", tagging_parm->temperr);
-  pp.query("max_temperr_lev", tagging_parm->max_temperr_lev);
-  pp.query("tempgrad", tagging_parm->tempgrad);
-  pp.query("max_tempgrad_lev", tagging_parm->max_tempgrad_lev);
+    int nmodes = 0;
+    if (ppc.query("value_greater", e.crit.value) != 0) {
+      e.crit.mode = TAG_GREATER;
+      nmodes++;
+    }
+    if (ppc.query("value_less", e.crit.value) != 0) {
+      e.crit.mode = TAG_LESS;
+      nmodes++;
+    }
+    if (ppc.query("abs_value_greater", e.crit.value) != 0) {
+      e.crit.mode = TAG_ABS_GREATER;
+      nmodes++;
+    }
+    if (ppc.query("adjacent_difference_greater", e.crit.value) != 0) {
+      e.crit.mode = TAG_GRAD;
+      nmodes++;
+    }
+    if (ppc.query("relative_difference_greater", e.crit.value) != 0) {
+      e.crit.mode = TAG_REL_GRAD;
+      nmodes++;
+    }
+    amrex::Vector<amrex::Real> between;
+    if (ppc.queryarr("value_between", between) != 0) {
+      if (between.size() != 2) {
+        amrex::Abort("tagging." + name + ".value_between needs two values");
+      }
+      e.crit.mode = TAG_BETWEEN;
+      e.crit.value = between[0];
+      e.crit.value_hi = between[1];
+      nmodes++;
+    }
+    if (nmodes != 1) {
+      amrex::Abort(
+        "Tagging criterion " + name + " needs exactly one of value_greater, "
+        "value_less, abs_value_greater, value_between, "
+        "adjacent_difference_greater or relative_difference_greater");
+    }
 
-  pp.query("ftracerr", tagging_parm->ftracerr);
-  pp.query("max_ftracerr_lev", tagging_parm->max_ftracerr_lev);
-  pp.query("ftracgrad", tagging_parm->ftracgrad);
-  pp.query("max_ftracgrad_lev", tagging_parm->max_ftracgrad_lev);
+    ppc.query("max_level", e.max_level);
+    ppc.query("start_time", e.start_time);
+    ppc.query("end_time", e.end_time);
+    ppc.query("level_ratio", e.level_ratio);
+    amrex::Vector<amrex::Real> box_lo;
+    amrex::Vector<amrex::Real> box_hi;
+    if (ppc.queryarr("in_box_lo", box_lo, 0, AMREX_SPACEDIM) != 0) {
+      for (int d = 0; d < AMREX_SPACEDIM; d++) {
+        e.crit.box_lo[d] = box_lo[d];
+      }
+    }
+    if (ppc.queryarr("in_box_hi", box_hi, 0, AMREX_SPACEDIM) != 0) {
+      for (int d = 0; d < AMREX_SPACEDIM; d++) {
+        e.crit.box_hi[d] = box_hi[d];
+      }
+    }
+    criteria.push_back(e);
+  }
 
-  pp.query("vfracerr", tagging_parm->vfracerr);
-  pp.query("max_vfracerr_lev", tagging_parm->max_vfracerr_lev);
+  if (verbose > 0) {
+    amrex::Print() << "Tagging criteria:";
+    for (const auto& e : criteria) {
+      amrex::Print() << " " << e.name;
+    }
+    amrex::Print() << std::endl;
+  }
 }
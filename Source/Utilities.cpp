@@ -23,8 +23,65 @@ read_binary(
     amrex::Abort("Unable to open input file " + iname);
   }
 
-  for (size_t i = 0; i < nx * ny * nz * ncol; i++) {
-    infile.read(reinterpret_cast<char*>(&data[i]), sizeof(data[i]));
+  const size_t n = nx * ny * nz * ncol;
+  data.resize(n);
+  infile.read(reinterpret_cast<char*>(data.data()), n * sizeof(double));
+  if (!infile) {
+    amrex::Abort("Input file " + iname + " is too short");
+  }
+  infile.close();
+}
+
+// -----------------------------------------------------------
+// Read some columns of some z-planes of a binary file of
+// nx*ny*nz points of ncol doubles each, x fastest. Contiguous
+// planes are read in bulk, one plane at a time.
+// INPUTS/OUTPUTS:
+// iname  => filename
+// nx     => input resolution
+// ny     => input resolution
+// nz     => input resolution
+// ncol   => number of columns per point
+// planes => ascending z-indices of the planes to read
+// cols   => columns to keep
+// data   <= output data, column n of point (i,j) of the p-th
+//           plane at n + cols.size() * (i + nx * (j + ny * p))
+// -----------------------------------------------------------
+void
+read_binary_planes(
+  const std::string& iname,
+  const size_t nx,
+  const size_t ny,
+  const size_t nz,
+  const size_t ncol,
+  const amrex::Vector<int>& planes,
+  const amrex::Vector<int>& cols,
+  amrex::Vector<amrex::Real>& data)
+{
+  std::ifstream infile(iname, std::ios::in | std::ios::binary);
+  if (!infile.is_open()) {
+    amrex::Abort("Unable to open input file " + iname);
+  }
+
+  const size_t plane_size = nx * ny * ncol;
+  const size_t nc = cols.size();
+  amrex::Vector<double> buf(plane_size);
+  data.resize(planes.size() * nx * ny * nc);
+  for (int p = 0; p < planes.size(); p++) {
+    AMREX_ALWAYS_ASSERT(planes[p] >= 0 && planes[p] < static_cast<int>(nz));
+    if (p == 0 || planes[p] != planes[p - 1] + 1) {
+      infile.seekg(planes[p] * plane_size * sizeof(double));
+    }
+    infile.read(
+      reinterpret_cast<char*>(buf.data()), plane_size * sizeof(double));
+    if (!infile) {
+      amrex::Abort("Input file " + iname + " is too short");
+    }
+    for (size_t m = 0; m < nx * ny; m++) {
+      for (size_t n = 0; n < nc; n++) {
+        data[n + nc * (m + nx * ny * p)] = buf[cols[n] + ncol * m];
+      }
+    }
   }
   infile.close();
 }
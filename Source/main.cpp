@@ -141,6 +141,9 @@ main(int argc, char* argv[])
          (amrptr->cumTime() < stop_time || stop_time < 0.0)) {
     // Do a timestep
     amrptr->coarseTimeStep(stop_time);
+
+    // Remap the levels whose work became unbalanced (pelec.loadbalance_int)
+    PeleC::rebalanceLevels(*amrptr);
   }
 
   // Write final checkpoint
@@ -0,0 +1,320 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Run PeleC performance benchmarks and compare them to a baseline.
+
+run:     run a PeleC case on a single level with its grid scaled and a
+         fixed number of steps, then write the BL_PROFILE region timings
+         (from the TinyProfiler report in the log), cells/second/core
+         and peak memory to a JSON file
+gtest:   run disabled GoogleTest benchmarks of the unit test executable
+         and write the times they record as "time_<region>" properties,
+         and peak memory, to a JSON file
+compare: flag the regions and rates of result files that got slower
+         than the baseline file of the same name by more than a tolerance
+"""
+
+# ========================================================================
+#
+# Imports
+#
+# ========================================================================
+import argparse
+import datetime
+import json
+import os
+import re
+import resource
+import shlex
+import socket
+import subprocess
+import sys
+
+
+# ========================================================================
+#
+# Functions
+#
+# ========================================================================
+def parse_tiny_profiler(lines):
+    """Parse the exclusive and inclusive TinyProfiler tables.
+
+    Rows are "name ncalls min avg max max%", the name may have spaces.
+    """
+    regions = {}
+    kind = None
+    row = re.compile(r"^(.+?)\s+(\d+)\s+(\S+)\s+(\S+)\s+(\S+)\s+(\S+)%\s*$")
+    for line in lines:
+        if line.startswith("Name") and "Excl. Min" in line:
+            kind = "excl"
+            continue
+        if line.startswith("Name") and "Incl. Min" in line:
+            kind = "incl"
+            continue
+        if kind is None:
+            continue
+        m = row.match(line)
+        if not m:
+            if line.strip() and not line.startswith("-"):
+                kind = None
+            continue
+        name = m.group(1).strip()
+        try:
+            tmin, tavg, tmax = (float(m.group(i)) for i in (3, 4, 5))
+        except ValueError:
+            continue
+        reg = regions.setdefault(name, {"ncalls": int(m.group(2))})
+        reg[kind] = {"min": tmin, "avg": tavg, "max": tmax}
+    return regions
+
+
+def parse_run_time(lines, key):
+    """Value of the last "key = value" line of the PeleC output."""
+    value = None
+    for line in lines:
+        if line.startswith(key + " ="):
+            value = float(line.split("=")[1])
+    return value
+
+
+def read_n_cell(inputs):
+    """Last amr.n_cell given in a PeleC inputs file."""
+    n_cell = None
+    with open(inputs, "r") as f:
+        for line in f:
+            line = line.split("#")[0]
+            if re.match(r"^\s*amr\.n_cell\s*=", line):
+                n_cell = [int(n) for n in line.split("=")[1].split()]
+    if n_cell is None:
+        sys.exit("benchmark.py run: no amr.n_cell in {0}".format(inputs))
+    return n_cell
+
+
+def run(args):
+    """Run the benchmark command and write the JSON results."""
+    cmd = args.command
+    if cmd and cmd[0] == "--":
+        cmd = cmd[1:]
+    if not cmd:
+        sys.exit("benchmark.py run: no command given")
+
+    n_cell = [args.scale * n for n in read_n_cell(args.inputs)]
+    cells = 1
+    for n in n_cell:
+        cells *= n
+    cmd = cmd + [
+        args.inputs,
+        "amr.n_cell=" + " ".join(str(n) for n in n_cell),
+        "amr.max_level=0",
+        "max_step={0}".format(args.steps),
+        "stop_time=1.0e30",
+        "amr.plot_files_output=0",
+        "amr.checkpoint_files_output=0",
+        "amrex.use_profiler_syncs=0",
+    ] + args.options.split()
+
+    with open(args.log, "w") as log:
+        proc = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT)
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    if proc.returncode != 0:
+        sys.exit(
+            "benchmark.py run: {0} failed with code {1}".format(
+                " ".join(cmd), proc.returncode
+            )
+        )
+
+    with open(args.log, "r") as log:
+        lines = log.read().splitlines()
+
+    run_time = parse_run_time(lines, "Run time w/o init")
+    if run_time is None:
+        run_time = parse_run_time(lines, "Run time")
+    cores = args.ranks * args.threads
+    cell_updates = cells * args.steps
+    rate = None
+    if run_time:
+        rate = cell_updates / (run_time * cores)
+
+    # ru_maxrss is in kilobytes on Linux, bytes on macOS
+    peak = usage.ru_maxrss * (1 if sys.platform == "darwin" else 1024)
+
+    results = {
+        "name": args.name,
+        "date": datetime.datetime.now().isoformat(),
+        "host": socket.gethostname(),
+        "command": " ".join(shlex.quote(c) for c in cmd),
+        "ranks": args.ranks,
+        "threads": args.threads,
+        "n_cell": n_cell,
+        "cells": cells,
+        "steps": args.steps,
+        "run_time": run_time,
+        "cells_per_second_per_core": rate,
+        "peak_memory_bytes": peak,
+        "regions": parse_tiny_profiler(lines),
+    }
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+    print("{0}: {1} s, {2} cells/s/core".format(args.name, run_time, rate))
+    if not results["regions"]:
+        print("No TinyProfiler report found, build with TINY_PROFILE")
+
+
+def gtest(args):
+    """Run GoogleTest benchmarks and write their timings as JSON results."""
+    cmd = args.command
+    if cmd and cmd[0] == "--":
+        cmd = cmd[1:]
+    if not cmd:
+        sys.exit("benchmark.py gtest: no command given")
+
+    report = args.output + ".gtest"
+    cmd = cmd + [
+        "--gtest_also_run_disabled_tests",
+        "--gtest_filter=" + args.filter,
+        "--gtest_output=json:" + report,
+    ]
+    with open(args.log, "w") as log:
+        proc = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT)
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    if proc.returncode != 0:
+        sys.exit(
+            "benchmark.py gtest: {0} failed with code {1}".format(
+                " ".join(cmd), proc.returncode
+            )
+        )
+
+    with open(report, "r") as f:
+        suites = json.load(f)
+    regions = {}
+    for suite in suites.get("testsuites", []):
+        for test in suite.get("testsuite", []):
+            nrep = int(test.get("nrep", 1))
+            for key, value in test.items():
+                if not key.startswith("time_"):
+                    continue
+                t = float(value)
+                regions[key[len("time_") :]] = {
+                    "ncalls": nrep,
+                    "excl": {"min": t, "avg": t, "max": t},
+                }
+    if not regions:
+        sys.exit("benchmark.py gtest: no test matching {0}".format(args.filter))
+
+    # ru_maxrss is in kilobytes on Linux, bytes on macOS
+    peak = usage.ru_maxrss * (1 if sys.platform == "darwin" else 1024)
+
+    results = {
+        "name": args.name,
+        "date": datetime.datetime.now().isoformat(),
+        "host": socket.gethostname(),
+        "command": " ".join(shlex.quote(c) for c in cmd),
+        "peak_memory_bytes": peak,
+        "regions": regions,
+    }
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+    for name in sorted(regions):
+        t = regions[name]["excl"]["max"]
+        print("{0}: {1} {2:.6g} s".format(args.name, name, t))
+
+
+def compare(args):
+    """Compare result files to the baseline files with the same name."""
+    regressions = []
+    for result in args.results:
+        baseline = os.path.join(args.baseline, os.path.basename(result))
+        if not os.path.isfile(baseline):
+            print("{0}: no baseline in {1}, skipping".format(result, args.baseline))
+            continue
+        with open(result, "r") as f:
+            new = json.load(f)
+        with open(baseline, "r") as f:
+            old = json.load(f)
+
+        # Lower is better for times and memory, higher for the rate
+        old_rate = old.get("cells_per_second_per_core")
+        new_rate = new.get("cells_per_second_per_core")
+        if old_rate and new_rate and new_rate < old_rate / (1.0 + args.tol):
+            regressions.append(
+                (new["name"], "cells_per_second_per_core", old_rate, new_rate)
+            )
+        old_mem = old.get("peak_memory_bytes")
+        new_mem = new.get("peak_memory_bytes")
+        if old_mem and new_mem and new_mem > old_mem * (1.0 + args.mem_tol):
+            regressions.append((new["name"], "peak_memory_bytes", old_mem, new_mem))
+        for name, reg in new.get("regions", {}).items():
+            old_reg = old.get("regions", {}).get(name)
+            if not old_reg or "excl" not in reg or "excl" not in old_reg:
+                continue
+            told = old_reg["excl"]["max"]
+            tnew = reg["excl"]["max"]
+            # Ignore regions too short to time reliably
+            if told < args.min_time and tnew < args.min_time:
+                continue
+            if tnew > told * (1.0 + args.tol):
+                regressions.append((new["name"], name, told, tnew))
+
+    for name, what, old, new in regressions:
+        print(
+            "REGRESSION {0}: {1} {2:.6g} -> {3:.6g} ({4:+.1f}%)".format(
+                name, what, old, new, 100.0 * (new - old) / old
+            )
+        )
+    if regressions:
+        sys.exit(1)
+    print("No performance regressions")
+
+
+# ========================================================================
+#
+# Main
+#
+# ========================================================================
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest="mode")
+    sub.required = True
+
+    prun = sub.add_parser("run", help="run a benchmark")
+    prun.add_argument("--name", required=True, help="benchmark name")
+    prun.add_argument("--output", required=True, help="JSON results file")
+    prun.add_argument("--log", required=True, help="PeleC output file")
+    prun.add_argument("--inputs", required=True, help="PeleC inputs file")
+    prun.add_argument("--scale", type=int, default=1, help="n_cell multiplier")
+    prun.add_argument("--options", default="", help="extra PeleC options")
+    prun.add_argument("--steps", type=int, required=True, help="number of steps")
+    prun.add_argument("--ranks", type=int, default=1, help="MPI ranks")
+    prun.add_argument("--threads", type=int, default=1, help="threads per rank")
+    prun.add_argument("command", nargs=argparse.REMAINDER, help="command to run")
+    prun.set_defaults(func=run)
+
+    pgt = sub.add_parser("gtest", help="run GoogleTest benchmarks")
+    pgt.add_argument("--name", required=True, help="benchmark name")
+    pgt.add_argument("--output", required=True, help="JSON results file")
+    pgt.add_argument("--log", required=True, help="test output file")
+    pgt.add_argument("--filter", required=True, help="GoogleTest filter")
+    pgt.add_argument("command", nargs=argparse.REMAINDER, help="command to run")
+    pgt.set_defaults(func=gtest)
+
+    pcmp = sub.add_parser("compare", help="compare results to a baseline")
+    pcmp.add_argument("--baseline", required=True, help="baseline directory")
+    pcmp.add_argument(
+        "--tol", type=float, default=0.1, help="relative slowdown tolerated"
+    )
+    pcmp.add_argument(
+        "--mem-tol", type=float, default=0.1, help="relative memory growth tolerated"
+    )
+    pcmp.add_argument(
+        "--min-time", type=float, default=0.05, help="shortest region compared [s]"
+    )
+    pcmp.add_argument("results", nargs="+", help="JSON results files")
+    pcmp.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
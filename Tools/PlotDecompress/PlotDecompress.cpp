@@ -0,0 +1,100 @@
+#include <fstream>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include "PlotCompress.H"
+
+// Convert a plotfile written with pelec.plot_compress = 1 back to a
+// standard plotfile:
+//
+//   PlotDecompress.ex infile=plt00100 [outfile=plt00100_raw]
+//
+// Without outfile the plotfile is converted in place.
+
+namespace {
+
+bool
+file_exists(const std::string& name)
+{
+  std::ifstream ifs(name);
+  return ifs.good();
+}
+
+void
+copy_file(const std::string& from, const std::string& to)
+{
+  std::ifstream ifs(from, std::ios::binary);
+  std::ofstream ofs(to, std::ios::binary);
+  if (!ofs.good()) {
+    amrex::FileOpenFailed(to);
+  }
+  ofs << ifs.rdbuf();
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  amrex::Initialize(argc, argv);
+  {
+    amrex::ParmParse pp;
+    std::string infile;
+    pp.get("infile", infile);
+    std::string outfile = infile;
+    pp.query("outfile", outfile);
+
+    // The MultiFab of each level is named by a Level_<n>/Cell line
+    std::ifstream header(infile + "/Header");
+    if (!header.good()) {
+      amrex::FileOpenFailed(infile + "/Header");
+    }
+    amrex::Vector<std::string> mf_names;
+    std::string line;
+    while (std::getline(header, line)) {
+      if (line.compare(0, 6, "Level_") == 0 && line.find('/') != line.npos) {
+        mf_names.push_back(line);
+      }
+    }
+
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+      if (!amrex::UtilCreateDirectory(outfile, 0755)) {
+        amrex::CreateDirectoryFailed(outfile);
+      }
+      if (outfile != infile) {
+        copy_file(infile + "/Header", outfile + "/Header");
+        if (file_exists(infile + "/job_info")) {
+          copy_file(infile + "/job_info", outfile + "/job_info");
+        }
+      }
+    }
+    amrex::ParallelDescriptor::Barrier();
+
+    for (const auto& name : mf_names) {
+      const std::string in_path = infile + "/" + name;
+      if (!file_exists(in_path + "_Z_H")) {
+        amrex::Print() << "Skipping " << in_path << ", not compressed\n";
+        continue;
+      }
+      const std::string out_path = outfile + "/" + name;
+      if (amrex::ParallelDescriptor::IOProcessor()) {
+        const std::string dir = out_path.substr(0, out_path.rfind('/'));
+        if (!amrex::UtilCreateDirectory(dir, 0755)) {
+          amrex::CreateDirectoryFailed(dir);
+        }
+      }
+      amrex::ParallelDescriptor::Barrier();
+
+      amrex::MultiFab mf;
+      pc_read_compressed_mf(mf, in_path);
+      amrex::VisMF::Write(mf, out_path);
+      amrex::Print() << "Wrote " << out_path << '\n';
+    }
+  }
+  amrex::Finalize();
+  return 0;
+}